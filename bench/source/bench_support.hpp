@@ -0,0 +1,45 @@
+#ifndef INI_MANAGER_BENCH_SUPPORT_HPP
+#define INI_MANAGER_BENCH_SUPPORT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ratio>
+#include <vector>
+
+/**
+ * @file bench_support.hpp
+ * @brief Timing helpers shared by the benchmarks.
+ */
+
+namespace ini_bench
+{
+
+/**
+ * @brief Times a call repeatedly and takes the median, which unlike the mean is not
+ * skewed by the occasional run interrupted by the scheduler.
+ * @tparam Period The unit of the result, milliseconds by default.
+ * @param repetitions The number of runs, at least one.
+ * @param function The function to time.
+ * @return The median duration of one run.
+ */
+template <typename Period = std::milli, typename Function>
+auto median_time(std::size_t repetitions, Function &&function) -> double
+{
+	std::vector<double> samples;
+	samples.reserve(repetitions);
+	for (std::size_t run = 0; run < repetitions; ++run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const std::chrono::duration<double, Period> elapsed =
+			std::chrono::steady_clock::now() - start;
+		samples.push_back(elapsed.count());
+	}
+	std::ranges::sort(samples);
+	return samples[samples.size() / 2];
+}
+
+} // namespace ini_bench
+
+#endif // INI_MANAGER_BENCH_SUPPORT_HPP
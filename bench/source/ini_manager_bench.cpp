@@ -0,0 +1,385 @@
+#include "bench_support.hpp"
+#include "ini_manager/ini_manager.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <optional>
+#include <ratio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef INI_MANAGER_TRACK_ALLOCATIONS
+#include "allocation_tracker.hpp"
+#endif
+
+// Microbenchmarks of the core ini_manager operations: parsing small, medium and huge
+// inputs, lookups that hit and miss, set_value, writing, merges and the section and
+// key accessors. Prints a table, or with --json one JSON document suited for
+// comparing runs. With --corpus, the operations run on a corpus file, such as one
+// made by ini_manager_corpus, instead of the generated medium configuration.
+// Configured with ini_manager_TRACK_ALLOCATIONS, it also reports the heap
+// allocations and bytes allocated per operation.
+// Usage: ini_manager_bench [--json] [--corpus file] [repetitions]
+
+namespace
+{
+
+/**
+ * @brief The shape of a generated configuration.
+ */
+struct corpus_shape
+{
+	std::string_view name;
+	std::size_t sections;
+	std::size_t keys;
+};
+
+/**
+ * @brief The result of one benchmark: the median time of one operation and, when
+ * tracked, the allocations it made.
+ */
+struct result
+{
+	std::string name;
+	std::size_t operations;
+	double ns_per_operation;
+	std::size_t bytes;
+	double allocations = 0;
+	double allocated_bytes = 0;
+};
+
+#ifdef INI_MANAGER_TRACK_ALLOCATIONS
+constexpr bool tracks_allocations = true;
+#else
+constexpr bool tracks_allocations = false;
+#endif
+
+// Consumes benchmark results so that the compiler cannot drop the work
+std::size_t sink = 0;
+
+auto make_text(const corpus_shape &shape) -> std::string
+{
+	std::string text;
+	for (std::size_t section = 0; section < shape.sections; ++section)
+	{
+		text += std::format("[section_{}]\n", section);
+		for (std::size_t key = 0; key < shape.keys; ++key)
+		{
+			text += std::format("key_{} = {}\n", key, section * shape.keys + key);
+		}
+	}
+	return text;
+}
+
+/**
+ * @brief Reads a whole corpus file into one string of exactly its size, which the
+ * parse benchmarks then read in place.
+ */
+auto read_corpus(const std::string &path) -> std::optional<std::string>
+{
+	std::ifstream file{path, std::ios::binary | std::ios::ate};
+	if (!file)
+	{
+		return std::nullopt;
+	}
+	std::string contents(static_cast<std::size_t>(file.tellg()), '\0');
+	file.seekg(0);
+	if (!file.read(contents.data(), static_cast<std::streamsize>(contents.size())))
+	{
+		return std::nullopt;
+	}
+	return contents;
+}
+
+/**
+ * @brief Parses text without copying it into a string stream.
+ */
+auto parse_text(std::string_view text) -> std::expected<ini::ini_manager, std::error_code>
+{
+	ini::detail::memory_streambuf buffer{text};
+	std::istream stream{&buffer};
+	return ini::ini_manager::from_stream(stream);
+}
+
+/**
+ * @brief Parses the repetition count, which must be a plain decimal number.
+ */
+auto parse_repetitions(std::string_view argument) -> std::optional<std::size_t>
+{
+	std::size_t repetitions = 0;
+	const auto [end, error] =
+		std::from_chars(argument.data(), argument.data() + argument.size(), repetitions);
+	if (argument.empty() || error != std::errc{} ||
+		end != argument.data() + argument.size())
+	{
+		return std::nullopt;
+	}
+	return std::max<std::size_t>(1, repetitions);
+}
+
+/**
+ * @brief Picks `count` sections and keys spread evenly over the entries of a
+ * configuration, going round again if it holds fewer.
+ */
+void sample_names(const ini::ini_manager &manager, std::size_t count,
+				  std::vector<std::string> &section_names,
+				  std::vector<std::string> &key_names)
+{
+	const auto stride = std::max<std::size_t>(1, manager.stats().keys / count);
+	std::size_t visited = 0;
+	manager.for_each(
+		[&](std::string_view section, std::string_view key, std::string_view) {
+			if (visited++ % stride == 0 && section_names.size() < count)
+			{
+				section_names.emplace_back(section);
+				key_names.emplace_back(key);
+			}
+		});
+	for (std::size_t index = 0; !section_names.empty() && section_names.size() < count;
+		 ++index)
+	{
+		section_names.push_back(section_names[index]);
+		key_names.push_back(key_names[index]);
+	}
+}
+
+template <typename Function>
+auto measure(std::string name, std::size_t repetitions, std::size_t operations,
+			 std::size_t bytes, Function &&function) -> result
+{
+	result measured{std::move(name), operations, 0.0, bytes};
+	measured.ns_per_operation = ini_bench::median_time<std::nano>(repetitions, function) /
+								static_cast<double>(operations);
+
+#ifdef INI_MANAGER_TRACK_ALLOCATIONS
+	// Counted in a separate run, so that the timings do not include the counting
+	const auto counts = ini_test::count_allocations(function);
+	measured.allocations =
+		static_cast<double>(counts.allocations) / static_cast<double>(operations);
+	measured.allocated_bytes =
+		static_cast<double>(counts.bytes) / static_cast<double>(operations);
+#endif
+	return measured;
+}
+
+void print_table(const std::vector<result> &results)
+{
+	for (const auto &result : results)
+	{
+		std::cout << std::format("{:<40} {:>14.1f} ns/op", result.name,
+								 result.ns_per_operation);
+		if (result.bytes != 0)
+		{
+			const auto mib_per_second = static_cast<double>(result.bytes) /
+										(result.ns_per_operation / 1e9) / (1024 * 1024);
+			std::cout << std::format(" {:>10.1f} MiB/s", mib_per_second);
+		}
+		if (tracks_allocations)
+		{
+			std::cout << std::format(" {:>10.2f} allocs/op {:>12.1f} B/op",
+									 result.allocations, result.allocated_bytes);
+		}
+		std::cout << '\n';
+	}
+}
+
+void print_json(const std::vector<result> &results, std::size_t repetitions)
+{
+	std::cout << std::format("{{\n  \"repetitions\": {},\n  \"benchmarks\": [\n",
+							 repetitions);
+	for (std::size_t index = 0; index < results.size(); ++index)
+	{
+		const auto &result = results[index];
+		std::cout << std::format("    {{\"name\": \"{}\", \"operations\": {}, "
+								 "\"ns_per_op\": {:.3f}, \"bytes_per_op\": {}",
+								 result.name, result.operations,
+								 result.ns_per_operation, result.bytes);
+		if (tracks_allocations)
+		{
+			std::cout << std::format(", \"allocations_per_op\": {:.3f}, "
+									 "\"allocated_bytes_per_op\": {:.1f}",
+									 result.allocations, result.allocated_bytes);
+		}
+		std::cout << std::format("}}{}\n", index + 1 < results.size() ? "," : "");
+	}
+	std::cout << "  ]\n}\n";
+}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	bool json = false;
+	std::string corpus;
+	std::size_t repetitions = 5;
+	for (int index = 1; index < argc; ++index)
+	{
+		const std::string_view argument = argv[index];
+		if (argument == "--json")
+		{
+			json = true;
+		}
+		else if (argument == "--corpus" && index + 1 < argc)
+		{
+			corpus = argv[++index];
+		}
+		else if (const auto count = parse_repetitions(argument); count.has_value())
+		{
+			repetitions = *count;
+		}
+		else
+		{
+			std::cerr << std::format("Unexpected argument {}\n"
+									 "Usage: {} [--json] [--corpus file] [repetitions]\n",
+									 argument, argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<result> results;
+	const auto run = [&results, repetitions](std::string name, std::size_t operations,
+											 std::size_t bytes, auto &&function) {
+		results.push_back(
+			measure(std::move(name), repetitions, operations, bytes, function));
+	};
+
+	const auto parse = [&run](std::string_view name, std::string_view text) {
+		run(std::format("parse/{}", name), 1, text.size(), [text] {
+			sink += parse_text(text)->get_sections().size();
+		});
+	};
+
+	const corpus_shape shapes[] = {
+		{"small", 10, 8}, {"medium", 1000, 16}, {"huge", 100000, 16}};
+	const auto &shape = shapes[1];
+	constexpr std::size_t lookups = 100000;
+	std::string label{shape.name};
+	ini::ini_manager manager;
+	std::vector<std::string> section_names;
+	std::vector<std::string> key_names;
+	if (corpus.empty())
+	{
+		for (const auto &generated : shapes)
+		{
+			parse(generated.name, make_text(generated));
+		}
+
+		// The remaining operations run against the medium configuration
+		std::istringstream medium{make_text(shape)};
+		manager = *ini::ini_manager::from_stream(medium);
+		for (std::size_t index = 0; index < lookups; ++index)
+		{
+			section_names.push_back(
+				std::format("section_{}", index * 7 % shape.sections));
+			key_names.push_back(std::format("key_{}", index % shape.keys));
+		}
+	}
+	else
+	{
+		const auto text = read_corpus(corpus);
+		auto loaded = parse_text(text.has_value() ? std::string_view{*text} : "");
+		if (!text.has_value() || !loaded.has_value())
+		{
+			std::cerr << std::format("Cannot load the corpus {}\n", corpus);
+			return 1;
+		}
+		label = "corpus";
+		parse(label, *text);
+		manager = std::move(*loaded);
+		sample_names(manager, lookups, section_names, key_names);
+		if (section_names.empty())
+		{
+			std::cerr << std::format("The corpus {} holds no keys\n", corpus);
+			return 1;
+		}
+	}
+
+	const auto lookup = [&](std::string name, std::string_view key_prefix, auto get) {
+		run(std::move(name), lookups, 0, [&, key_prefix] {
+			for (std::size_t index = 0; index < lookups; ++index)
+			{
+				const ini::section section{section_names[index]};
+				const ini::key key{key_prefix.empty() ? std::string_view{key_names[index]}
+													  : key_prefix};
+				sink += get(section, key);
+			}
+		});
+	};
+	lookup("get_value/hit", {}, [&manager](ini::section section, ini::key key) {
+		return manager.get_value(section, key).has_value() ? 1U : 0U;
+	});
+	lookup("get_value/miss", "absent", [&manager](ini::section section, ini::key key) {
+		return manager.get_value(section, key).has_value() ? 1U : 0U;
+	});
+	lookup("get_value<int>/hit", {}, [&manager](ini::section section, ini::key key) {
+		return static_cast<std::size_t>(manager.get_value<int>(section, key).value_or(0));
+	});
+	lookup("get_value<int>/miss", "absent",
+		   [&manager](ini::section section, ini::key key) {
+			   return static_cast<std::size_t>(
+				   manager.get_value<int>(section, key).value_or(0));
+		   });
+	lookup("get_value_view/hit", {}, [&manager](ini::section section, ini::key key) {
+		return manager.get_value_view(section, key).has_value() ? 1U : 0U;
+	});
+
+	run("set_value/existing", lookups, 0, [&] {
+		for (std::size_t index = 0; index < lookups; ++index)
+		{
+			manager.set_value(section_names[index], key_names[index], index);
+		}
+	});
+	std::size_t round = 0;
+	run("set_value/new", lookups, 0, [&] {
+		ini::ini_manager fresh;
+		for (std::size_t index = 0; index < lookups; ++index)
+		{
+			fresh.set_value(section_names[index], std::format("new_{}", index), round);
+		}
+		sink += fresh.get_sections().size() + ++round;
+	});
+
+	std::ostringstream written;
+	written << manager;
+	const auto written_bytes = static_cast<std::size_t>(written.tellp());
+	run(std::format("write/{}", label), 1, written_bytes, [&manager] {
+		std::ostringstream stream;
+		stream << manager;
+		sink += static_cast<std::size_t>(stream.tellp());
+	});
+
+	const auto overlay = make_text({"overlay", shape.sections / 2, shape.keys / 2});
+	// Merging the same overlay again reassigns the keys the first merge set
+	run("add_from_stream/merge", 1, overlay.size(), [&] {
+		std::istringstream stream{overlay};
+		sink += manager.add_from_stream(stream).has_value() ? 1U : 0U;
+	});
+
+	run("get_sections", 1, 0, [&manager] { sink += manager.get_sections().size(); });
+	const auto listed = std::min(shape.sections, section_names.size());
+	run("get_keys", listed, 0, [&] {
+		for (std::size_t index = 0; index < listed; ++index)
+		{
+			sink += manager.get_keys(ini::section{section_names[index]}).size();
+		}
+	});
+
+	if (json)
+	{
+		print_json(results, repetitions);
+	}
+	else
+	{
+		print_table(results);
+	}
+	return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+#include "bench_support.hpp"
+#include "ini_manager/ini_manager.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+
+// Compares the startup cost of parsing an INI file with `from_file` against loading
+// it through its sidecar cache and against mapping the same data compiled with
+// `save_binary`, each followed by a first lookup.
+// Usage: ini_manager_binary_bench [sections] [keys_per_section] [repetitions]
+
+auto main(int argc, char **argv) -> int
+{
+	const auto argument = [argc, argv](int index, std::size_t fallback) {
+		return index < argc ? static_cast<std::size_t>(std::stoull(argv[index]))
+							: fallback;
+	};
+	const std::size_t sections = argument(1, 2000);
+	const std::size_t keys = argument(2, 50);
+	const std::size_t repetitions = argument(3, 10);
+
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto ini_path = (directory / "ini_manager_binary_bench.ini").string();
+	const auto binary_path = (directory / "ini_manager_binary_bench.inib").string();
+
+	ini::ini_manager source;
+	for (std::size_t section = 0; section < sections; ++section)
+	{
+		const auto name = std::format("section_{}", section);
+		for (std::size_t key = 0; key < keys; ++key)
+		{
+			source.set_value(name, std::format("key_{}", key),
+							 std::format("value_{}_{}", section, key));
+		}
+	}
+	if (!source.write_file(ini_path).has_value() ||
+		!source.save_binary(binary_path).has_value())
+	{
+		std::cerr << "Failed to write benchmark inputs to " << directory << '\n';
+		return 1;
+	}
+
+	const ini::section probe_section{"section_0"};
+	const ini::key probe_key{"key_0"};
+	std::size_t hits = 0;
+
+	const auto text_ms = ini_bench::median_time(repetitions, [&] {
+		auto manager = ini::ini_manager::from_file(ini_path);
+		hits += manager.has_value() && manager->get_value(probe_section, probe_key);
+	});
+	const ini::load_options cached{.sidecar_cache = true};
+	const auto cached_ms = ini_bench::median_time(repetitions, [&] {
+		auto manager = ini::ini_manager::from_file(ini_path, cached);
+		hits += manager.has_value() && manager->get_value(probe_section, probe_key);
+	});
+	const auto binary_ms = ini_bench::median_time(repetitions, [&] {
+		auto config = ini::binary_config::from_binary(binary_path, false);
+		hits += config.has_value() && config->get_value_view(probe_section, probe_key);
+	});
+	const auto verified_ms = ini_bench::median_time(repetitions, [&] {
+		auto config = ini::binary_config::from_binary(binary_path);
+		hits += config.has_value() && config->get_value_view(probe_section, probe_key);
+	});
+
+	std::cout << std::format("entries: {} ({} sections x {} keys), hits: {}\n",
+							 sections * keys, sections, keys, hits);
+	std::cout << std::format("ini file:    {} bytes\n",
+							 std::filesystem::file_size(ini_path));
+	std::cout << std::format("binary file: {} bytes\n",
+							 std::filesystem::file_size(binary_path));
+	std::cout << std::format("from_file + lookup:                     {:.3f} ms\n",
+							 text_ms);
+	std::cout << std::format("from_file (sidecar cache) + lookup:     {:.3f} ms\n",
+							 cached_ms);
+	std::cout << std::format("from_binary + lookup:                   {:.3f} ms\n",
+							 binary_ms);
+	std::cout << std::format("from_binary (checksum verified) + lookup: {:.3f} ms\n",
+							 verified_ms);
+
+	std::filesystem::remove(ini_path);
+	std::filesystem::remove(binary_path);
+	std::filesystem::remove(ini_path + ".inicache");
+	return 0;
+}
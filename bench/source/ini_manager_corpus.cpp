@@ -0,0 +1,355 @@
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Writes a synthetic INI corpus shaped like production configurations: many tiny
+// sections, a few huge ones, short and long values, comments, CRLF line endings,
+// duplicate keys and reopened sections. The same seed and options always produce the
+// same bytes on every platform, so corpora can be regenerated instead of stored.
+// Usage: ini_manager_corpus <size>[K|M|G] [output|-] [--seed N] [--option value...]
+
+namespace
+{
+
+/**
+ * @brief An inclusive range of counts or lengths.
+ */
+struct range
+{
+	std::size_t min;
+	std::size_t max;
+};
+
+/**
+ * @brief The distributions the corpus is drawn from. Rates are probabilities
+ * between 0 and 1.
+ */
+struct corpus_options
+{
+	std::uint64_t seed = 42;
+	range tiny_keys{1, 4};
+	double huge_rate = 0.01;
+	range huge_keys{500, 2000};
+	range value_length{4, 24};
+	double long_value_rate = 0.02;
+	range long_value_length{256, 4096};
+	double comment_rate = 0.05;
+	double crlf_rate = 0.25;
+	double duplicate_rate = 0.01;
+	double reopen_rate = 0.005;
+};
+
+/**
+ * @brief SplitMix64, chosen over the standard engines and distributions because its
+ * output is specified bit for bit, not per standard library.
+ */
+class random_source
+{
+  public:
+	explicit random_source(std::uint64_t seed) : m_state(seed)
+	{
+	}
+
+	auto next() -> std::uint64_t
+	{
+		auto value = (m_state += 0x9E3779B97F4A7C15ULL);
+		value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31U);
+	}
+
+	auto between(range bounds) -> std::size_t
+	{
+		const auto span = bounds.max - bounds.min + 1;
+		return bounds.min + static_cast<std::size_t>(next() % span);
+	}
+
+	auto chance(double rate) -> bool
+	{
+		return static_cast<double>(next() >> 11U) * 0x1.0p-53 < rate;
+	}
+
+  private:
+	std::uint64_t m_state;
+};
+
+/**
+ * @brief Writes lines to an output stream through a buffer, counting the bytes.
+ */
+class corpus_writer
+{
+  public:
+	corpus_writer(std::ostream &output, random_source &random, double crlf_rate)
+		: m_output(output), m_random(random), m_crlf_rate(crlf_rate)
+	{
+	}
+
+	corpus_writer(const corpus_writer &) = delete;
+	auto operator=(const corpus_writer &) -> corpus_writer & = delete;
+
+	~corpus_writer()
+	{
+		flush();
+	}
+
+	void line(std::string_view text)
+	{
+		m_buffer += text;
+		m_buffer += m_random.chance(m_crlf_rate) ? "\r\n" : "\n";
+		if (m_buffer.size() >= buffer_size)
+		{
+			flush();
+		}
+	}
+
+	auto bytes() const noexcept -> std::uint64_t
+	{
+		return m_written + m_buffer.size();
+	}
+
+	void flush()
+	{
+		m_output.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		m_written += m_buffer.size();
+		m_buffer.clear();
+	}
+
+  private:
+	static constexpr std::size_t buffer_size = std::size_t{1} << 20U;
+
+	std::ostream &m_output;
+	random_source &m_random;
+	double m_crlf_rate;
+	std::string m_buffer;
+	std::uint64_t m_written = 0;
+};
+
+auto make_value(random_source &random, std::size_t length) -> std::string
+{
+	// Values never start or end with a blank, which parsing would trim
+	static constexpr std::string_view alphabet =
+		"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-/:";
+	std::string value(length, ' ');
+	for (auto &character : value)
+	{
+		character = alphabet[random.next() % alphabet.size()];
+	}
+	return value;
+}
+
+void write_corpus(std::ostream &output, std::uint64_t size, const corpus_options &options)
+{
+	random_source random{options.seed};
+	corpus_writer writer{output, random, options.crlf_rate};
+	writer.line(std::format("; ini_manager_corpus seed={} size={}", options.seed, size));
+
+	// Sections are numbered in order of appearance, so names stay dense
+	std::size_t emitted = 0;
+	while (writer.bytes() < size)
+	{
+		// Reopening repeats an earlier header, whose keys then merge or override
+		const auto reopened = emitted > 0 && random.chance(options.reopen_rate);
+		const auto name = reopened ? random.between({0, emitted - 1}) : emitted++;
+		if (random.chance(options.comment_rate))
+		{
+			writer.line(std::format("; section {} settings", name));
+		}
+		writer.line(std::format("[section_{}]", name));
+
+		const auto keys = random.chance(options.huge_rate)
+							  ? random.between(options.huge_keys)
+							  : random.between(options.tiny_keys);
+		for (std::size_t key = 0; key < keys && writer.bytes() < size; ++key)
+		{
+			if (random.chance(options.comment_rate))
+			{
+				writer.line(std::format("# key_{} follows", key));
+			}
+			const auto length = random.chance(options.long_value_rate)
+									? random.between(options.long_value_length)
+									: random.between(options.value_length);
+			const auto written_key = key > 0 && random.chance(options.duplicate_rate)
+										 ? random.between({0, key - 1})
+										 : key;
+			writer.line(
+				std::format("key_{} = {}", written_key, make_value(random, length)));
+		}
+	}
+}
+
+auto parse_size(std::string_view text) -> std::uint64_t
+{
+	std::uint64_t size = 0;
+	const auto [end, error] =
+		std::from_chars(text.data(), text.data() + text.size(), size);
+	if (error != std::errc{} || size == 0)
+	{
+		return 0;
+	}
+	const std::string_view suffix{end, text.data() + text.size()};
+	if (suffix.empty())
+	{
+		return size;
+	}
+	if (suffix.size() != 1)
+	{
+		return 0;
+	}
+	switch (suffix.front())
+	{
+	case 'K':
+	case 'k':
+		return size << 10U;
+	case 'M':
+	case 'm':
+		return size << 20U;
+	case 'G':
+	case 'g':
+		return size << 30U;
+	default:
+		return 0;
+	}
+}
+
+auto parse_number(std::string_view text, auto &number) -> bool
+{
+	const auto [end, error] =
+		std::from_chars(text.data(), text.data() + text.size(), number);
+	return error == std::errc{} && end == text.data() + text.size();
+}
+
+auto parse_range(std::string_view text, range &bounds) -> bool
+{
+	const auto dash = text.find('-');
+	if (dash == std::string_view::npos)
+	{
+		return parse_number(text, bounds.min) && parse_number(text, bounds.max);
+	}
+	return parse_number(text.substr(0, dash), bounds.min) &&
+		   parse_number(text.substr(dash + 1), bounds.max) && bounds.min <= bounds.max;
+}
+
+auto parse_rate(std::string_view text, double &rate) -> bool
+{
+	return parse_number(text, rate) && rate >= 0.0 && rate <= 1.0;
+}
+
+auto parse_option(std::string_view name, std::string_view value, corpus_options &options)
+	-> bool
+{
+	if (name == "--seed")
+	{
+		return parse_number(value, options.seed);
+	}
+	if (name == "--tiny-keys")
+	{
+		return parse_range(value, options.tiny_keys);
+	}
+	if (name == "--huge-rate")
+	{
+		return parse_rate(value, options.huge_rate);
+	}
+	if (name == "--huge-keys")
+	{
+		return parse_range(value, options.huge_keys);
+	}
+	if (name == "--value-length")
+	{
+		return parse_range(value, options.value_length) && options.value_length.min > 0;
+	}
+	if (name == "--long-value-rate")
+	{
+		return parse_rate(value, options.long_value_rate);
+	}
+	if (name == "--long-value-length")
+	{
+		return parse_range(value, options.long_value_length) &&
+			   options.long_value_length.min > 0;
+	}
+	if (name == "--comment-rate")
+	{
+		return parse_rate(value, options.comment_rate);
+	}
+	if (name == "--crlf-rate")
+	{
+		return parse_rate(value, options.crlf_rate);
+	}
+	if (name == "--duplicate-rate")
+	{
+		return parse_rate(value, options.duplicate_rate);
+	}
+	if (name == "--reopen-rate")
+	{
+		return parse_rate(value, options.reopen_rate);
+	}
+	return false;
+}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto usage = [] {
+		std::cerr << "Usage: ini_manager_corpus <size>[K|M|G] [output|-] [--seed N]\n"
+					 "  [--tiny-keys MIN-MAX] [--huge-rate RATE] [--huge-keys MIN-MAX]\n"
+					 "  [--value-length MIN-MAX] [--long-value-rate RATE]\n"
+					 "  [--long-value-length MIN-MAX] [--comment-rate RATE]\n"
+					 "  [--crlf-rate RATE] [--duplicate-rate RATE]\n"
+					 "  [--reopen-rate RATE]\n";
+		return 2;
+	};
+
+	std::vector<std::string_view> positional;
+	corpus_options options;
+	for (int index = 1; index < argc; ++index)
+	{
+		const std::string_view argument{argv[index]};
+		if (!argument.starts_with("--"))
+		{
+			positional.push_back(argument);
+			continue;
+		}
+		if (index + 1 == argc || !parse_option(argument, argv[index + 1], options))
+		{
+			std::cerr << std::format("ini_manager_corpus: invalid option '{}'\n",
+									 argument);
+			return usage();
+		}
+		++index;
+	}
+	if (positional.empty() || positional.size() > 2)
+	{
+		return usage();
+	}
+	const auto size = parse_size(positional[0]);
+	if (size == 0)
+	{
+		std::cerr << std::format("ini_manager_corpus: invalid size '{}'\n",
+								 positional[0]);
+		return usage();
+	}
+
+	if (positional.size() == 1 || positional[1] == "-")
+	{
+		write_corpus(std::cout, size, options);
+		return std::cout.flush() ? 0 : 1;
+	}
+	const std::string output_path{positional[1]};
+	std::ofstream output(output_path, std::ios::binary);
+	write_corpus(output, size, options);
+	output.close();
+	if (output.fail())
+	{
+		std::cerr << std::format("ini_manager_corpus: cannot write to '{}'\n",
+								 output_path);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include "bench_support.hpp"
+#include "ini_manager/ini_manager.hpp"
+
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <string_view>
+
+// Compares glob queries over section and key names: a std::regex matched against
+// every name from get_sections/get_keys, a compiled ini::glob matched against every
+// name, and the prefix-pruned sections_matching/for_each_match queries.
+// Usage: ini_manager_glob_bench [sections] [keys_per_section] [repetitions]
+
+auto main(int argc, char **argv) -> int
+{
+	const auto argument = [argc, argv](int index, std::size_t fallback) {
+		return index < argc ? static_cast<std::size_t>(std::stoull(argv[index]))
+							: fallback;
+	};
+	const std::size_t sections = argument(1, 100000);
+	const std::size_t keys = argument(2, 4);
+	const std::size_t repetitions = argument(3, 5);
+
+	// One section in ten belongs to a tenant
+	ini::ini_manager manager;
+	for (std::size_t section = 0; section < sections; ++section)
+	{
+		const auto name = section % 10 == 0 ? std::format("tenant-{}", section)
+											: std::format("service-{}", section);
+		for (std::size_t key = 0; key < keys; ++key)
+		{
+			manager.set_value(name, std::format("client.{}.timeout_ms", key), key);
+			manager.set_value(name, std::format("client.{}.retries", key), key);
+		}
+	}
+
+	const auto tenants = *ini::glob::compile("tenant-*");
+	const auto timeouts = *ini::glob::compile("*.timeout_ms");
+	const std::regex tenant_regex{"tenant-.*"};
+	const std::regex timeout_regex{".*\\.timeout_ms"};
+	std::size_t sections_found = 0;
+	std::size_t entries_found = 0;
+
+	const auto regex_sections_ms = ini_bench::median_time(repetitions, [&] {
+		for (const auto &name : manager.get_sections())
+		{
+			sections_found += std::regex_match(name, tenant_regex) ? 1U : 0U;
+		}
+	});
+	const auto glob_sections_ms = ini_bench::median_time(repetitions, [&] {
+		for (const auto name : manager.sections())
+		{
+			sections_found += tenants.matches(name) ? 1U : 0U;
+		}
+	});
+	const auto pruned_sections_ms = ini_bench::median_time(repetitions, [&] {
+		const auto matching = std::ranges::distance(manager.sections_matching(tenants));
+		sections_found += static_cast<std::size_t>(matching);
+	});
+
+	const auto regex_entries_ms = ini_bench::median_time(repetitions, [&] {
+		for (const auto &section : manager.get_sections())
+		{
+			if (!std::regex_match(section, tenant_regex))
+			{
+				continue;
+			}
+			for (const auto &key : manager.get_keys(ini::section{section}))
+			{
+				entries_found += std::regex_match(key, timeout_regex) ? 1U : 0U;
+			}
+		}
+	});
+	const auto pruned_entries_ms = ini_bench::median_time(repetitions, [&] {
+		manager.for_each_match(tenants, timeouts,
+							   [&entries_found](std::string_view, std::string_view,
+												std::string_view) { ++entries_found; });
+	});
+
+	std::cout << std::format("sections: {}, keys per section: {}, matches: {} / {}\n",
+							 sections, keys * 2, sections_found, entries_found);
+	std::cout << std::format("[tenant-*] std::regex over get_sections:  {:.3f} ms\n",
+							 regex_sections_ms);
+	std::cout << std::format("[tenant-*] glob over sections():          {:.3f} ms\n",
+							 glob_sections_ms);
+	std::cout << std::format("[tenant-*] sections_matching:             {:.3f} ms\n",
+							 pruned_sections_ms);
+	std::cout << std::format("[tenant-*] *.timeout_ms std::regex:       {:.3f} ms\n",
+							 regex_entries_ms);
+	std::cout << std::format("[tenant-*] *.timeout_ms for_each_match:   {:.3f} ms\n",
+							 pruned_entries_ms);
+	return 0;
+}
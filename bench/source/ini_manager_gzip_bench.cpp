@@ -0,0 +1,87 @@
+#include "bench_support.hpp"
+#include "ini_manager/ini_manager.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Compares the throughput of loading a plain INI file with loading its gzip-compressed
+// copy through the streaming decompressor, and with the usual workaround of inflating
+// the whole file into a std::stringstream before calling from_stream.
+// Usage: ini_manager_gzip_bench [sections] [keys_per_section] [repetitions]
+
+auto main(int argc, char **argv) -> int
+{
+	const auto argument = [argc, argv](int index, std::size_t fallback) {
+		return index < argc ? static_cast<std::size_t>(std::stoull(argv[index]))
+							: fallback;
+	};
+	const std::size_t sections = argument(1, 5000);
+	const std::size_t keys = argument(2, 50);
+	const std::size_t repetitions = argument(3, 5);
+
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto ini_path = (directory / "ini_manager_gzip_bench.ini").string();
+	const auto gzip_path = ini_path + ".gz";
+
+	ini::ini_manager source;
+	for (std::size_t section = 0; section < sections; ++section)
+	{
+		const auto name = std::format("section_{}", section);
+		for (std::size_t key = 0; key < keys; ++key)
+		{
+			source.set_value(name, std::format("key_{}", key),
+							 std::format("value_{}_{}", section, key));
+		}
+	}
+	if (!source.write_file(ini_path).has_value() ||
+		!source.write_file(gzip_path).has_value())
+	{
+		std::cerr << "Failed to write benchmark inputs to " << directory << '\n';
+		return 1;
+	}
+
+	std::size_t loaded = 0;
+	const auto plain_ms = ini_bench::median_time(repetitions, [&] {
+		loaded += ini::ini_manager::from_file(ini_path).has_value();
+	});
+	const auto streaming_ms = ini_bench::median_time(repetitions, [&] {
+		loaded += ini::ini_manager::from_file(gzip_path).has_value();
+	});
+	const auto buffered_ms = ini_bench::median_time(repetitions, [&] {
+		std::ifstream file(gzip_path, std::ios::binary);
+		ini::detail::gzip_istreambuf buffer{file};
+		std::stringstream text;
+		text << &buffer;
+		loaded += ini::ini_manager::from_stream(text).has_value();
+	});
+
+	const auto text_bytes = static_cast<double>(std::filesystem::file_size(ini_path));
+	const auto throughput = [text_bytes](double milliseconds) {
+		constexpr double bytes_per_megabyte = 1024.0 * 1024.0;
+		return text_bytes / bytes_per_megabyte / (milliseconds / 1000.0);
+	};
+	std::cout << std::format("entries: {} ({} sections x {} keys), loads: {}\n",
+							 sections * keys, sections, keys, loaded);
+	std::cout << std::format("ini file:  {} bytes\n",
+							 std::filesystem::file_size(ini_path));
+	std::cout << std::format("gzip file: {} bytes\n",
+							 std::filesystem::file_size(gzip_path));
+	std::cout << std::format("from_file (plain):                     {:.3f} ms, "
+							 "{:.1f} MB/s\n",
+							 plain_ms, throughput(plain_ms));
+	std::cout << std::format("from_file (gzip, streaming):           {:.3f} ms, "
+							 "{:.1f} MB/s\n",
+							 streaming_ms, throughput(streaming_ms));
+	std::cout << std::format("inflate to stringstream + from_stream: {:.3f} ms, "
+							 "{:.1f} MB/s\n",
+							 buffered_ms, throughput(buffered_ms));
+
+	std::filesystem::remove(ini_path);
+	std::filesystem::remove(gzip_path);
+	return 0;
+}
@@ -5,6 +5,11 @@ if(BUILD_TESTING)
 	add_subdirectory(test)
 endif()
 
+option(BUILD_BENCHMARKS "Build benchmarks tree." ON)
+if(BUILD_BENCHMARKS)
+	add_subdirectory(bench)
+endif()
+
 option(BUILD_DOCS "Build documentation using Doxygen" OFF)
 if(BUILD_DOCS)
 	include(cmake/docs.cmake)
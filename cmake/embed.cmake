@@ -0,0 +1,48 @@
+# ini_manager_embed(<target> <ini_file> NAME <name> [NAMESPACE <namespace>])
+#
+# Converts <ini_file> at build time into a C++ source defining
+# `extern const ini::static_config <namespace>::<name>` (namespace defaults to
+# ini_embedded) over pre-hashed, read-only tables, and adds it to <target>.
+# Include "<name>.hpp" to use it. The data is linked into the binary, so nothing
+# is parsed at startup. Requires the ini_manager_embed tool, which is built when
+# ini_manager_BUILD_EMBED_TOOL is enabled and then installed with the package as
+# ini_manager::embed.
+function(ini_manager_embed TARGET INI_FILE)
+	cmake_parse_arguments(PARSE_ARGV 2 EMBED "" "NAME;NAMESPACE" "")
+	if(NOT EMBED_NAME)
+		message(FATAL_ERROR "ini_manager_embed: NAME is required")
+	endif()
+	if(NOT EMBED_NAMESPACE)
+		set(EMBED_NAMESPACE ini_embedded)
+	endif()
+	# The generator of this build tree, or the one installed with the package
+	if(TARGET ini_manager_embed)
+		set(tool ini_manager_embed)
+	elseif(TARGET ini_manager::embed)
+		set(tool ini_manager::embed)
+	else()
+		message(
+			FATAL_ERROR
+			"ini_manager_embed: the generator is not built, "
+			"set ini_manager_BUILD_EMBED_TOOL to ON"
+		)
+	endif()
+
+	get_filename_component(input "${INI_FILE}" ABSOLUTE)
+	set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/ini_manager_embed/${TARGET}")
+	set(header "${output_dir}/${EMBED_NAME}.hpp")
+	set(source "${output_dir}/${EMBED_NAME}.cpp")
+
+	add_custom_command(
+		OUTPUT "${header}" "${source}"
+		COMMAND "$<TARGET_FILE:${tool}>"
+			"${input}" "${output_dir}" "${EMBED_NAME}" "${EMBED_NAMESPACE}"
+		DEPENDS "${input}" "${tool}"
+		COMMENT "Embedding ${INI_FILE} as ${EMBED_NAMESPACE}::${EMBED_NAME}"
+		VERBATIM
+	)
+
+	target_sources("${TARGET}" PRIVATE "${header}" "${source}")
+	target_include_directories("${TARGET}" PRIVATE "${output_dir}")
+	target_link_libraries("${TARGET}" PRIVATE ini_manager::ini_manager)
+endfunction()
@@ -1 +1,4 @@
+include(CMakeFindDependencyMacro)
+include("${CMAKE_CURRENT_LIST_DIR}/ini_managerDependencies.cmake")
 include("${CMAKE_CURRENT_LIST_DIR}/ini_managerTargets.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/ini_managerEmbed.cmake")
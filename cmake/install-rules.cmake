@@ -27,11 +27,25 @@ install(
 	INCLUDES DESTINATION "${CMAKE_INSTALL_INCLUDEDIR}"
 )
 
-write_basic_package_version_file(
-	"${package}ConfigVersion.cmake"
-	COMPATIBILITY SameMajorVersion
-	ARCH_INDEPENDENT
-)
+# The embed generator makes the package architecture dependent
+if(TARGET ini_manager_embed)
+	install(
+		TARGETS ini_manager_embed
+		EXPORT ini_managerTargets
+		RUNTIME DESTINATION "${CMAKE_INSTALL_BINDIR}"
+		COMPONENT ini_manager_Runtime
+	)
+	write_basic_package_version_file(
+		"${package}ConfigVersion.cmake"
+		COMPATIBILITY SameMajorVersion
+	)
+else()
+	write_basic_package_version_file(
+		"${package}ConfigVersion.cmake"
+		COMPATIBILITY SameMajorVersion
+		ARCH_INDEPENDENT
+	)
+endif()
 
 # Allow package maintainers to freely override the path for the configs
 set(
@@ -41,6 +55,29 @@ set(
 set_property(CACHE ini_manager_INSTALL_CMAKEDIR PROPERTY TYPE PATH)
 mark_as_advanced(ini_manager_INSTALL_CMAKEDIR)
 
+# find_dependency() calls for the optional dependencies the build was configured with
+set(dependencies "")
+if(ini_manager_WITH_ZLIB)
+	string(APPEND dependencies "find_dependency(ZLIB)\n")
+endif()
+file(
+	WRITE "${PROJECT_BINARY_DIR}/${package}Dependencies.cmake"
+	"${dependencies}"
+)
+
+install(
+	FILES "${PROJECT_BINARY_DIR}/${package}Dependencies.cmake"
+	DESTINATION "${ini_manager_INSTALL_CMAKEDIR}"
+	COMPONENT ini_manager_Development
+)
+
+install(
+	FILES cmake/embed.cmake
+	DESTINATION "${ini_manager_INSTALL_CMAKEDIR}"
+	RENAME "${package}Embed.cmake"
+	COMPONENT ini_manager_Development
+)
+
 install(
 	FILES cmake/install-config.cmake
 	DESTINATION "${ini_manager_INSTALL_CMAKEDIR}"
@@ -1,8 +1,10 @@
 set(
 	FORMAT_PATTERNS
+	bench/*.cpp bench/*.hpp
 	example/*.cpp example/*.hpp
 	include/*.hpp
 	test/*.cpp test/*.hpp
+	tools/*.cpp tools/*.hpp
 	CACHE STRING
 	"; separated patterns relative to the project source dir to format"
 )
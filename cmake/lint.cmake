@@ -9,9 +9,11 @@ endmacro()
 default(FORMAT_COMMAND clang-format)
 default(
 	PATTERNS
+	bench/*.cpp bench/*.hpp
 	example/*.cpp example/*.hpp
 	include/*.hpp
 	test/*.cpp test/*.hpp
+	tools/*.cpp tools/*.hpp
 )
 default(FIX NO)
 
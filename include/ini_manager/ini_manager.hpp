@@ -9,22 +9,62 @@
 #ifndef INI_MANAGER_HPP
 #define INI_MANAGER_HPP
 
+#include "metrics.hpp"
+#include "tracing.hpp"
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <charconv>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <expected>
+#include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <random>
 #include <ranges>
+#include <set>
+#include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INI_MANAGER_HAS_MMAP 1
+#else
+#define INI_MANAGER_HAS_MMAP 0
+#endif
+
+// Defined by the build when ini_manager_WITH_ZLIB is enabled
+#if defined(INI_MANAGER_WITH_ZLIB)
+#include <zlib.h>
+#define INI_MANAGER_HAS_ZLIB 1
+#else
+#define INI_MANAGER_HAS_ZLIB 0
+#endif
+
 namespace ini
 {
 
@@ -76,556 +116,4764 @@ struct key
 };
 
 /**
- * @brief Manages INI file data, allowing reading, writing, and manipulation of
- * configuration settings.
+ * @brief A 128-bit fingerprint of INI data. Fingerprints add up: the fingerprint of a
+ * configuration is the wrapping sum of those of its sections.
  */
-class ini_manager
+struct fingerprint128
 {
-	// Define the underlying data map type for brevity
-	using data_map = std::map<std::string, std::map<std::string, std::string>>;
-
-  public:
 	/**
-	 * @brief Default constructor for the ini_manager class.
-	 *
-	 * Initializes an empty INI configuration.
+	 * @brief The low half, which is also the 64-bit fingerprint.
 	 */
-	ini_manager() : m_data(std::make_shared<data_map>())
-	{
-	}
-
+	std::uint64_t low = 0;
 	/**
-	 * @brief Creates an ini_manager object by loading data from a file.
-	 * @param file_path The path to the INI file.
-	 * @return A `std::expected` containing the ini_manager object on success,
-	 * or a `std::error_code` on failure.
+	 * @brief The high half, computed with independent seeds.
 	 */
-	static auto from_file(const std::string &file_path)
-		-> std::expected<ini_manager, std::error_code>
+	std::uint64_t high = 0;
+
+	auto operator==(const fingerprint128 &) const -> bool = default;
+
+	constexpr auto operator+=(const fingerprint128 &other) noexcept -> fingerprint128 &
 	{
-		ini_manager manager;
-		auto result = manager.load(file_path);
-		if (result.has_value())
-		{
-			manager.m_file_path = file_path;
-			return manager;
-		}
-		return std::unexpected(result.error());
+		low += other.low;
+		high += other.high;
+		return *this;
 	}
 
-	/**
-	 * @brief Creates an ini_manager object by parsing data from an input stream.
-	 * @param istream The input stream containing INI data.
-	 * @return A `std::expected` containing the ini_manager object on success,
-	 * or a `std::error_code` on failure.
-	 */
-	static auto from_stream(std::istream &istream)
-		-> std::expected<ini_manager, std::error_code>
+	constexpr auto operator-=(const fingerprint128 &other) noexcept -> fingerprint128 &
 	{
-		ini_manager manager;
-		auto result = manager.parse(istream);
-		if (result.has_value())
-		{
-			return manager;
-		}
-		return std::unexpected(result.error());
+		low -= other.low;
+		high -= other.high;
+		return *this;
 	}
+};
 
+/**
+ * @brief Counts summarizing a configuration, maintained with every change.
+ */
+struct statistics
+{
 	/**
-	 * @brief Provides non-const access to keys within a specific section.
+	 * @brief The number of sections, empty ones included.
 	 */
-	class section_accessor
+	std::size_t sections = 0;
+	/**
+	 * @brief The number of keys in all sections.
+	 */
+	std::size_t keys = 0;
+	/**
+	 * @brief The total length of the section names, keys and values.
+	 */
+	std::size_t payload_bytes = 0;
+	/**
+	 * @brief The section holding the most keys, the alphabetically first on ties, or
+	 * an empty name if there are no sections.
+	 */
+	std::string_view largest_section;
+	/**
+	 * @brief The number of keys in the largest section.
+	 */
+	std::size_t largest_section_keys = 0;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Converts the textual representation of a value to the requested type.
+ * @tparam T The type to convert to. Must be `std::string`, `bool`, or satisfy the
+ * `StreamExtractable` concept.
+ * @param value_str The text to convert.
+ * @return A `std::optional` containing the converted value, or `std::nullopt` if the
+ * text cannot be converted to the requested type.
+ */
+template <typename T>
+auto convert_value(std::string_view value_str) noexcept -> std::optional<T>
+{
+	if constexpr (std::is_same_v<T, std::string>)
 	{
-	  public:
-		/**
-		 * @brief Constructs a section_accessor.
-		 * @param data A shared pointer to the underlying data map.
-		 * @param section_name The name of the section.
-		 */
-		explicit section_accessor(std::shared_ptr<data_map> data,
-								  std::string section_name)
-			: m_data(std::move(data)), m_section_name(std::move(section_name))
+		return std::string{value_str};
+	}
+	else if constexpr (std::is_same_v<T, bool>)
+	{
+		// Use a local copy for modification
+		std::string lower_value{value_str};
+		std::ranges::transform(lower_value, lower_value.begin(), ::tolower);
+		// Trim potential whitespace around boolean value before comparison
+		lower_value = std::string{trim(lower_value)};
+
+		if (lower_value == "true" || lower_value == "1")
 		{
+			return true;
 		}
-
-		/**
-		 * @brief Accesses a key within the section for modification.
-		 * If the key does not exist, it will be created.
-		 * @param key The name of the key.
-		 * @return A reference to the string value associated with the key.
-		 */
-		auto operator[](std::string_view key) -> std::string &
+		if (lower_value == "false" || lower_value == "0")
 		{
-			return (*m_data)[m_section_name][std::string{key}];
+			return false;
 		}
-
-	  private:
-		std::shared_ptr<data_map> m_data;
-		std::string m_section_name;
-	};
-
-	/**
-	 * @brief Provides const access to keys within a specific section.
-	 */
-	class const_section_accessor
+	}
+	else if constexpr (StreamExtractable<T>)
 	{
-	  public:
-		/**
-		 * @brief Constructs a const_section_accessor.
-		 * @param data A shared pointer to the underlying data map (const).
-		 * @param section_name The name of the section.
-		 */
-		explicit const_section_accessor(std::shared_ptr<data_map> data,
-										std::string section_name)
-			: m_data(std::move(data)), m_section_name(std::move(section_name))
+		std::istringstream iss{std::string{value_str}};
+		T value;
+		// Check for successful extraction AND that the entire string was consumed
+		if ((iss >> value) && iss.eof())
 		{
+			return value;
 		}
+	}
+	return std::nullopt;
+}
 
-		/**
-		 * @brief Accesses a key within the section for reading.
-		 * @param key The name of the key.
-		 * @return A `std::optional` containing the string value associated with the key,
-		 * or `std::nullopt` if the key or section does not exist.
-		 */
-		auto operator[](std::string_view key) const -> std::optional<std::string>
+/**
+ * @brief Final avalanche step of the 64-bit hash (the splitmix64 finalizer).
+ * @param value The hash state to finalize.
+ * @return The finalized hash.
+ */
+constexpr auto mix64(std::uint64_t value) noexcept -> std::uint64_t
+{
+	value ^= value >> 30U;
+	value *= 0xBF58476D1CE4E5B9ULL;
+	value ^= value >> 27U;
+	value *= 0x94D049BB133111EBULL;
+	value ^= value >> 31U;
+	return value;
+}
+
+/**
+ * @brief Computes a 64-bit hash of a byte sequence, eight bytes at a time.
+ *
+ * The result depends only on the bytes and the seed, never on the platform or the
+ * build, so it can be stored in files and compared across processes. Usable in
+ * constant expressions.
+ * @param bytes The bytes to hash.
+ * @param seed The initial hash state; chaining hashes through it combines them.
+ * @return The 64-bit hash.
+ */
+constexpr auto hash_bytes(std::string_view bytes, std::uint64_t seed = 0) noexcept
+	-> std::uint64_t
+{
+	constexpr std::uint64_t first_multiplier = 0x87C37B91114253D5ULL;
+	constexpr std::uint64_t second_multiplier = 0x4CF5AD432745937FULL;
+	std::uint64_t hash = seed ^ (bytes.size() * 0x9E3779B97F4A7C15ULL);
+
+	const auto absorb = [&hash](std::string_view chunk) {
+		std::uint64_t word = 0;
+		for (std::size_t byte = 0; byte < chunk.size(); ++byte)
 		{
-			if (const auto it_section = (*m_data).find(m_section_name);
-				it_section != (*m_data).cend())
-			{
-				if (const auto it_key = it_section->second.find(std::string{key});
-					it_key != it_section->second.cend())
-				{
-					return it_key->second;
-				}
-			}
-			return std::nullopt;
+			word |= static_cast<std::uint64_t>(static_cast<unsigned char>(chunk[byte]))
+					<< (byte * 8U);
 		}
-
-	  private:
-		std::shared_ptr<data_map> m_data;
-		std::string m_section_name;
+		hash = std::rotl(hash ^ (word * first_multiplier), 31) * second_multiplier +
+			   0x52DCE729ULL;
 	};
 
-	/**
-	 * @brief Provides non-const access to a specific section.
-	 * @param section The name of the section.
-	 * @return A `section_accessor` object for accessing keys within the section.
-	 */
-	auto operator[](std::string_view section) -> section_accessor
+	std::size_t pos = 0;
+	for (; pos + 8 <= bytes.size(); pos += 8)
 	{
-		return section_accessor{m_data, std::string{section}};
+		absorb(bytes.substr(pos, 8));
 	}
-
-	/**
-	 * @brief Provides const access to a specific section.
-	 * @param section The name of the section.
-	 * @return A `const_section_accessor` object for accessing keys within the section.
-	 */
-	auto operator[](std::string_view section) const -> const_section_accessor
+	if (pos < bytes.size())
 	{
-		return const_section_accessor{m_data, std::string{section}};
+		absorb(bytes.substr(pos));
 	}
+	return mix64(hash);
+}
 
-	/**
-	 * @brief Retrieves a string value for a given section and key.
-	 * @param section The section containing the key.
-	 * @param key The key whose value to retrieve.
-	 * @return A `std::optional` containing the string value,
-	 * or `std::nullopt` if the section or key does not exist.
-	 */
-	auto get_value(section section, key key) const noexcept -> std::optional<std::string>
-	{
-		return (*this)[section.value][key.value];
-	}
+/**
+ * @brief Computes the hash identifying a key within a section.
+ * @param section The section name.
+ * @param key The key name.
+ * @return The 64-bit hash of the pair.
+ */
+constexpr auto hash_entry(std::string_view section, std::string_view key) noexcept
+	-> std::uint64_t
+{
+	return hash_bytes(key, hash_bytes(section));
+}
 
-	/**
-	 * @brief Retrieves a value of a specific type for a given section and key.
-	 * @tparam T The type of the value to retrieve. Must be `std::string`, `bool`,
-	 * or satisfy the `StreamExtractable` concept.
-	 * @param section The section containing the key.
-	 * @param key The key whose value to retrieve.
-	 * @return A `std::optional` containing the value of type `T`,
-	 * or `std::nullopt` if the section or key does not exist, or if the
-	 * value cannot be converted to the requested type.
-	 * @concept StreamExtractable<T>
-	 */
-	template <typename T>
-	auto get_value(section section, key key) const noexcept -> std::optional<T>
-	{
-		if (auto value_str = (*this)[section.value][key.value]; value_str.has_value())
-		{
-			if constexpr (std::is_same_v<T, std::string>)
-			{
-				return value_str;
-			}
-			else if constexpr (std::is_same_v<T, bool>)
-			{
-				// Use a local copy for modification
-				std::string lower_value = *value_str;
-				std::ranges::transform(lower_value, lower_value.begin(), ::tolower);
-				// Trim potential whitespace around boolean value before comparison
-				lower_value = std::string{trim(lower_value)};
+/**
+ * @brief Computes the seeds the fingerprints of a section's entries are derived from.
+ * The low seed equals `hash_bytes(section)`, so low fingerprint halves extend
+ * `hash_entry`.
+ * @param section The section name.
+ * @return The seeds.
+ */
+constexpr auto section_seeds(std::string_view section) noexcept -> fingerprint128
+{
+	constexpr std::uint64_t high_seed = 0x9C4E6BD1F0A25E37ULL;
+	return {hash_bytes(section), hash_bytes(section, high_seed)};
+}
 
-				if (lower_value == "true" || lower_value == "1")
-				{
-					return true;
-				}
-				if (lower_value == "false" || lower_value == "0")
-				{
-					return false;
-				}
-				return std::nullopt;
-			}
-			else if constexpr (StreamExtractable<T>)
-			{
-				std::istringstream iss(*value_str);
-				T value;
-				// Check for successful extraction AND that the entire string was consumed
-				if ((iss >> value) && iss.eof())
-				{
-					return value;
-				}
-			}
-		}
-		return std::nullopt;
-	}
+/**
+ * @brief Computes the fingerprint contribution of a section itself, so that empty
+ * sections count too.
+ *
+ * The fingerprint of a configuration is the wrapping sum of the contributions of its
+ * sections and entries, so it does not depend on their order and can be updated one
+ * entry at a time.
+ * @param section The section name.
+ * @return The contribution.
+ */
+constexpr auto section_fingerprint(std::string_view section) noexcept -> fingerprint128
+{
+	constexpr std::uint64_t low_seed = 0x5EC7104E5EC7104EULL;
+	constexpr std::uint64_t high_seed = 0xE7A1C3B5D9F20468ULL;
+	return {hash_bytes(section, low_seed), hash_bytes(section, high_seed)};
+}
 
-	/**
-	 * @brief Retrieves a string value for a given section and key, or a default value if
-	 * not found.
-	 * @param section The section containing the key.
-	 * @param key The key whose value to retrieve.
-	 * @param default_value The value to return if the section or key does not exist.
-	 * @return The string value associated with the key, or the default value.
-	 */
-	auto get_value_or_default(section section, key key,
-							  std::string default_value) const noexcept -> std::string
+/**
+ * @brief Computes the fingerprint contribution of an entry.
+ * @param seeds The seeds of the entry's section, from `section_seeds`.
+ * @param key The key name.
+ * @param value The value.
+ * @return The contribution.
+ */
+constexpr auto entry_fingerprint(const fingerprint128 &seeds, std::string_view key,
+								 std::string_view value) noexcept -> fingerprint128
+{
+	return {hash_bytes(value, hash_bytes(key, seeds.low)),
+			hash_bytes(value, hash_bytes(key, seeds.high))};
+}
+
+/**
+ * @brief Computes the fingerprint contribution of a section's declared parent.
+ * @param seeds The seeds of the section, from `section_seeds`.
+ * @param parent The parent's name.
+ * @return The contribution.
+ */
+constexpr auto parent_fingerprint(const fingerprint128 &seeds,
+								  std::string_view parent) noexcept -> fingerprint128
+{
+	constexpr std::uint64_t parent_seed = 0xA9E3F1C27B5D4086ULL;
+	return {hash_bytes(parent, seeds.low ^ parent_seed),
+			hash_bytes(parent, seeds.high ^ parent_seed)};
+}
+
+/**
+ * @brief Compares as greater than every string starting with a prefix and less than
+ * every later string, so `upper_bound` on an ordered map with a transparent comparator
+ * finds the end of the keys with that prefix without building a successor string.
+ */
+struct prefix_bound
+{
+	std::string_view prefix;
+
+	friend auto operator<(const prefix_bound &bound, std::string_view text) noexcept
+		-> bool
 	{
-		return get_value(section, key).value_or(std::move(default_value));
+		return text.substr(0, bound.prefix.size()) > bound.prefix;
 	}
 
-	/**
-	 * @brief Retrieves a value of a specific type for a given section and key,
-	 * or a default value if not found.
-	 * @tparam T The type of the value to retrieve. Must be `std::string`, `bool`,
-	 * or satisfy the `StreamExtractable` concept.
-	 * @param section The section containing the key.
-	 * @param key The key whose value to retrieve.
-	 * @param default_value The value to return if the section or key does not exist,
-	 * or if the value cannot be converted to the requested type.
-	 * @return The value of type `T` associated with the key, or the default value.
-	 * @concept StreamExtractable<T>
-	 */
-	template <typename T>
-	auto get_value_or_default(section section, key key, T default_value) const noexcept
-		-> T
+	friend auto operator<(std::string_view text, const prefix_bound &bound) noexcept
+		-> bool
 	{
-		return get_value<T>(section, key).value_or(std::move(default_value));
+		return text.substr(0, bound.prefix.size()) <= bound.prefix;
 	}
+};
 
-	/**
-	 * @brief Sets a value for a given section and key.
-	 * @tparam T The type of the value to set. Must be formattable using `std::format`.
-	 * @param section The name of the section.
-	 * @param key The name of the key.
-	 * @param value The value to set.
-	 * @requires std::formattable<T, char>
-	 */
-	template <typename T>
-		requires std::formattable<T, char>
-	void set_value(std::string_view section, std::string_view key, T value) noexcept
+/**
+ * @brief Views the names of a run of map elements, such as sections or keys, as
+ * `std::string_view`s.
+ * @param first The first element.
+ * @param last The end of the run.
+ * @return A lazy view over the names.
+ */
+template <typename Iterator> auto names(Iterator first, Iterator last)
+{
+	return std::ranges::subrange(first, last) | std::views::keys |
+		   std::views::transform(
+			   [](const std::string &name) { return std::string_view{name}; });
+}
+
+/**
+ * @brief Hashes strings for unordered containers that look up `std::string` keys by
+ * `std::string_view` without allocating.
+ */
+struct string_hash
+{
+	using is_transparent = void;
+
+	auto operator()(std::string_view text) const noexcept -> std::size_t
 	{
-		(*m_data)[std::string{section}][std::string{key}] = std::format("{}", value);
+		return std::hash<std::string_view>{}(text);
+	}
+};
+
+/**
+ * @brief Splits a dotted section name such as `service.cache.l1` into its components,
+ * lazily and without copying.
+ * @param name The section name.
+ * @return A view of the components.
+ */
+inline auto dotted_components(std::string_view name)
+{
+	return std::views::split(name, '.') | std::views::transform([](auto &&component) {
+			   return std::string_view{component.begin(), component.end()};
+		   });
+}
+
+/**
+ * @brief Orders section names so that every section precedes its dotted subsections
+ * and siblings are alphabetical: like `<`, except that `.` sorts before any other
+ * character.
+ */
+constexpr auto tree_order(std::string_view left, std::string_view right) noexcept
+	-> bool
+{
+	constexpr auto rank = [](char character) {
+		return character == '.' ? 0 : static_cast<unsigned char>(character) + 1;
+	};
+	return std::ranges::lexicographical_compare(left, right, {}, rank, rank);
+}
+
+/**
+ * @brief Views a byte buffer as characters, e.g. for hashing.
+ * @param bytes The bytes to view.
+ * @return A string view over the same memory.
+ */
+inline auto as_chars(std::span<const std::byte> bytes) noexcept -> std::string_view
+{
+	return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+/**
+ * @brief Magic bytes opening every compiled binary INI image.
+ */
+inline constexpr std::array<char, 8> binary_magic{'I', 'N', 'I', 'M',
+												   'G', 'R', 'B', '\0'};
+
+/**
+ * @brief Version of the compiled binary layout; bumped on every incompatible change.
+ */
+inline constexpr std::uint32_t binary_version = 1;
+
+/**
+ * @brief Written in native byte order to detect images produced on a host with a
+ * different endianness.
+ */
+inline constexpr std::uint32_t binary_endian_tag = 0x01020304;
+
+/**
+ * @brief Fixed-size header at the start of a compiled binary INI image.
+ *
+ * All offsets are relative to the start of the image, so the image is position
+ * independent and can be used from any mapping address.
+ */
+struct binary_header
+{
+	std::array<char, 8> magic;
+	std::uint32_t version;
+	std::uint32_t endian_tag;
+	std::uint64_t image_size;
+	std::uint64_t checksum;
+	std::uint64_t section_count;
+	std::uint64_t entry_count;
+	std::uint64_t bucket_count;
+	std::uint64_t sections_offset;
+	std::uint64_t entries_offset;
+	std::uint64_t buckets_offset;
+	std::uint64_t strings_offset;
+	std::uint64_t strings_size;
+};
+
+/**
+ * @brief Reference to a string stored in the string pool of a binary image.
+ */
+struct binary_string
+{
+	std::uint64_t offset;
+	std::uint64_t size;
+};
+
+/**
+ * @brief Section table record. Sections are sorted by name and own a contiguous,
+ * key-sorted run of the entry table.
+ */
+struct binary_section
+{
+	binary_string name;
+	std::uint64_t first_entry;
+	std::uint64_t entry_count;
+};
+
+/**
+ * @brief Entry table record holding one key-value pair.
+ */
+struct binary_entry
+{
+	binary_string key;
+	binary_string value;
+	std::uint64_t section;
+	std::uint64_t hash;
+};
+
+static_assert(sizeof(binary_header) == 96 && sizeof(binary_section) == 32 &&
+				  sizeof(binary_entry) == 48,
+			  "binary INI layout must not contain padding");
+
+/**
+ * @brief Computes the checksum of a binary image: the header with its checksum field
+ * zeroed, chained into a hash of everything after the header.
+ * @param header The image header.
+ * @param image The whole image.
+ * @return The 64-bit checksum.
+ */
+inline auto binary_checksum(binary_header header,
+							std::span<const std::byte> image) noexcept -> std::uint64_t
+{
+	header.checksum = 0;
+	const auto header_hash = hash_bytes(
+		std::string_view{reinterpret_cast<const char *>(&header), sizeof(header)});
+	return hash_bytes(as_chars(image.subspan(sizeof(binary_header))), header_hash);
+}
+
+/**
+ * @brief Rounds a size up to the 8-byte alignment used by every table of the image.
+ */
+constexpr auto align_binary(std::uint64_t size) noexcept -> std::uint64_t
+{
+	return (size + 7U) & ~std::uint64_t{7U};
+}
+
+/**
+ * @brief Serializes section data into a compiled binary INI image.
+ *
+ * Layout: header, section table, entry table, open-addressing hash index over the
+ * entries (one 64-bit slot per bucket, holding the entry index plus one or zero when
+ * empty) and a deduplicated string pool.
+ * @tparam Map A range of `(section name, range of (key, value))` pairs, ordered by
+ * section name and key.
+ * @param data The sections to serialize.
+ * @return The image bytes.
+ */
+template <typename Map> auto build_binary_image(const Map &data) -> std::vector<std::byte>
+{
+	std::vector<binary_section> sections;
+	std::vector<binary_entry> entries;
+	std::string strings;
+	std::unordered_map<std::string_view, std::uint64_t> pooled;
+
+	const auto intern = [&strings, &pooled](std::string_view text) -> binary_string {
+		const auto [it, inserted] = pooled.try_emplace(text, strings.size());
+		if (inserted)
+		{
+			strings.append(text);
+		}
+		return {it->second, text.size()};
+	};
+
+	sections.reserve(std::ranges::size(data));
+	for (const auto &[name, section_entries] : data)
+	{
+		sections.push_back(
+			{intern(name), entries.size(), std::ranges::size(section_entries)});
+		for (const auto &[key, value] : section_entries)
+		{
+			entries.push_back({intern(key), intern(value), sections.size() - 1,
+							   hash_entry(name, key)});
+		}
+	}
+
+	const std::uint64_t bucket_count =
+		entries.empty() ? 0 : std::bit_ceil(std::uint64_t{entries.size()} * 2);
+	std::vector<std::uint64_t> buckets(bucket_count, 0);
+	for (std::uint64_t index = 0; index < entries.size(); ++index)
+	{
+		auto slot = entries[index].hash & (bucket_count - 1);
+		while (buckets[slot] != 0)
+		{
+			slot = (slot + 1) & (bucket_count - 1);
+		}
+		buckets[slot] = index + 1;
+	}
+
+	binary_header header{};
+	header.magic = binary_magic;
+	header.version = binary_version;
+	header.endian_tag = binary_endian_tag;
+	header.section_count = sections.size();
+	header.entry_count = entries.size();
+	header.bucket_count = bucket_count;
+	header.sections_offset = sizeof(binary_header);
+	header.entries_offset =
+		header.sections_offset + sections.size() * sizeof(binary_section);
+	header.buckets_offset = header.entries_offset + entries.size() * sizeof(binary_entry);
+	header.strings_offset = header.buckets_offset + bucket_count * sizeof(std::uint64_t);
+	header.strings_size = strings.size();
+	header.image_size = align_binary(header.strings_offset + strings.size());
+
+	std::vector<std::byte> image(header.image_size);
+	const auto place = [&image](std::uint64_t offset, const void *source,
+								std::size_t size) {
+		if (size != 0)
+		{
+			std::memcpy(image.data() + offset, source, size);
+		}
+	};
+	place(header.sections_offset, sections.data(),
+		  sections.size() * sizeof(binary_section));
+	place(header.entries_offset, entries.data(), entries.size() * sizeof(binary_entry));
+	place(header.buckets_offset, buckets.data(), buckets.size() * sizeof(std::uint64_t));
+	place(header.strings_offset, strings.data(), strings.size());
+
+	header.checksum = binary_checksum(header, image);
+	place(0, &header, sizeof(header));
+	return image;
+}
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Uses `mmap` where available and falls back to reading the file into memory
+ * elsewhere, so callers only ever see a span of bytes.
+ */
+class mapped_file
+{
+  public:
+	mapped_file(const mapped_file &) = delete;
+	mapped_file(mapped_file &&) = delete;
+	auto operator=(const mapped_file &) -> mapped_file & = delete;
+	auto operator=(mapped_file &&) -> mapped_file & = delete;
+
+	~mapped_file()
+	{
+#if INI_MANAGER_HAS_MMAP
+		if (m_address != nullptr)
+		{
+			::munmap(m_address, m_size);
+		}
+#endif
+	}
+
+	/**
+	 * @brief Maps a file into memory.
+	 * @param file_path The path to the file.
+	 * @return A `std::expected` containing the mapping on success, or a
+	 * `std::error_code` on failure.
+	 */
+	static auto open(const std::string &file_path)
+		-> std::expected<std::shared_ptr<const mapped_file>, std::error_code>
+	{
+		std::shared_ptr<mapped_file> mapping{new mapped_file};
+#if INI_MANAGER_HAS_MMAP
+		const int descriptor = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (descriptor < 0)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		struct stat info{};
+		if (::fstat(descriptor, &info) != 0)
+		{
+			const int error = errno;
+			::close(descriptor);
+			return std::unexpected(std::error_code(error, std::system_category()));
+		}
+		mapping->m_size = static_cast<std::size_t>(info.st_size);
+		if (mapping->m_size != 0)
+		{
+			void *address =
+				::mmap(nullptr, mapping->m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (address == MAP_FAILED)
+			{
+				const int error = errno;
+				::close(descriptor);
+				return std::unexpected(std::error_code(error, std::system_category()));
+			}
+			mapping->m_address = address;
+		}
+		// The mapping stays valid after the descriptor is closed
+		::close(descriptor);
+#else
+		std::ifstream file(file_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		std::string contents{std::istreambuf_iterator<char>{file}, {}};
+		if (file.bad())
+		{
+			return std::unexpected(std::error_code(EIO, std::system_category()));
+		}
+		mapping->m_buffer.resize(contents.size());
+		std::memcpy(mapping->m_buffer.data(), contents.data(), contents.size());
+#endif
+		return mapping;
+	}
+
+	/**
+	 * @brief Gets the mapped bytes.
+	 * @return A span over the whole file contents.
+	 */
+	auto bytes() const noexcept -> std::span<const std::byte>
+	{
+#if INI_MANAGER_HAS_MMAP
+		return {static_cast<const std::byte *>(m_address), m_size};
+#else
+		return m_buffer;
+#endif
+	}
+
+  private:
+	mapped_file() = default;
+
+#if INI_MANAGER_HAS_MMAP
+	void *m_address = nullptr;
+	std::size_t m_size = 0;
+#else
+	std::vector<std::byte> m_buffer;
+#endif
+};
+
+/**
+ * @brief Input stream buffer reading directly from a block of memory.
+ */
+class memory_streambuf : public std::streambuf
+{
+  public:
+	/**
+	 * @brief Constructs a stream buffer over the given characters, which must outlive
+	 * it.
+	 * @param text The characters to read.
+	 */
+	explicit memory_streambuf(std::string_view text)
+	{
+		// std::streambuf only offers a non-const get area; it is never written to
+		char *begin = const_cast<char *>(text.data());
+		setg(begin, begin, begin + text.size());
+	}
+};
+
+/**
+ * @brief Checks whether a stream holds gzip data, without consuming anything.
+ *
+ * Only the first magic byte is examined, since it can be peeked from any stream; it is
+ * a control character that never starts INI text, and the decompressor validates the
+ * rest of the header.
+ * @param istream The stream to examine.
+ * @return `true` if the stream starts like gzip data.
+ */
+inline auto is_gzip(std::istream &istream) -> bool
+{
+	constexpr std::istream::int_type gzip_first_byte = 0x1F;
+	return istream.peek() == gzip_first_byte;
+}
+
+#if INI_MANAGER_HAS_ZLIB
+
+/**
+ * @brief Size of the blocks gzip data is read, inflated and deflated in.
+ */
+inline constexpr std::size_t gzip_block_size = std::size_t{64} * 1024;
+
+/**
+ * @brief Input stream buffer inflating gzip data read from another stream.
+ *
+ * The compressed data is read and inflated one block at a time, so memory use stays
+ * bounded however large the decompressed text is. Concatenated gzip members are read
+ * as one stream, like `gzip -d` does.
+ */
+class gzip_istreambuf : public std::streambuf
+{
+  public:
+	/**
+	 * @brief Constructs a stream buffer inflating the given stream, which must outlive
+	 * it.
+	 * @param source The stream of compressed data.
+	 */
+	explicit gzip_istreambuf(std::istream &source)
+		: m_source(source), m_input(gzip_block_size), m_output(gzip_block_size)
+	{
+		constexpr int gzip_window_bits = MAX_WBITS + 16;
+		if (inflateInit2(&m_stream, gzip_window_bits) != Z_OK)
+		{
+			m_error = std::make_error_code(std::errc::not_enough_memory);
+		}
+	}
+
+	gzip_istreambuf(const gzip_istreambuf &) = delete;
+	gzip_istreambuf(gzip_istreambuf &&) = delete;
+	auto operator=(const gzip_istreambuf &) -> gzip_istreambuf & = delete;
+	auto operator=(gzip_istreambuf &&) -> gzip_istreambuf & = delete;
+
+	~gzip_istreambuf() override
+	{
+		inflateEnd(&m_stream);
+	}
+
+	/**
+	 * @brief Gets the error that ended the decompressed data early, if any:
+	 * `std::errc::bad_message` for corrupt or truncated gzip data, or the error of the
+	 * underlying stream.
+	 * @return The error, or an empty error code.
+	 */
+	auto error() const noexcept -> std::error_code
+	{
+		return m_error;
+	}
+
+  protected:
+	auto underflow() -> int_type override
+	{
+		while (!m_error && !m_finished)
+		{
+			if (m_stream.avail_in == 0)
+			{
+				m_source.read(m_input.data(),
+							  static_cast<std::streamsize>(m_input.size()));
+				if (m_source.bad())
+				{
+					m_error = std::error_code(EIO, std::system_category());
+					break;
+				}
+				if (m_source.gcount() == 0)
+				{
+					// The data ended before the end of the gzip member
+					m_error = std::make_error_code(std::errc::bad_message);
+					break;
+				}
+				m_stream.next_in = reinterpret_cast<Bytef *>(m_input.data());
+				m_stream.avail_in = static_cast<uInt>(m_source.gcount());
+			}
+
+			m_stream.next_out = reinterpret_cast<Bytef *>(m_output.data());
+			m_stream.avail_out = static_cast<uInt>(m_output.size());
+			const int status = inflate(&m_stream, Z_NO_FLUSH);
+			if (status == Z_STREAM_END)
+			{
+				// Another gzip member may follow
+				if (m_stream.avail_in == 0 &&
+					m_source.peek() == std::istream::traits_type::eof())
+				{
+					m_finished = true;
+				}
+				else
+				{
+					inflateReset(&m_stream);
+				}
+			}
+			else if (status != Z_OK && status != Z_BUF_ERROR)
+			{
+				m_error = std::make_error_code(std::errc::bad_message);
+			}
+
+			const auto produced = m_output.size() - m_stream.avail_out;
+			if (produced > 0)
+			{
+				setg(m_output.data(), m_output.data(),
+					 m_output.data() + static_cast<std::ptrdiff_t>(produced));
+				return traits_type::to_int_type(*gptr());
+			}
+		}
+		return traits_type::eof();
+	}
+
+  private:
+	std::istream &m_source;
+	std::vector<char> m_input;
+	std::vector<char> m_output;
+	z_stream m_stream{};
+	bool m_finished = false;
+	std::error_code m_error;
+};
+
+/**
+ * @brief Output stream buffer deflating everything written to it into gzip data
+ * written to another stream, one block at a time.
+ */
+class gzip_ostreambuf : public std::streambuf
+{
+  public:
+	/**
+	 * @brief Constructs a stream buffer deflating into the given stream, which must
+	 * outlive it.
+	 * @param sink The stream receiving the compressed data.
+	 */
+	explicit gzip_ostreambuf(std::ostream &sink)
+		: m_sink(sink), m_input(gzip_block_size), m_output(gzip_block_size)
+	{
+		constexpr int gzip_window_bits = MAX_WBITS + 16;
+		constexpr int memory_level = 8;
+		m_ok = deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+							gzip_window_bits, memory_level, Z_DEFAULT_STRATEGY) == Z_OK;
+		setp(m_input.data(), m_input.data() + m_input.size());
+	}
+
+	gzip_ostreambuf(const gzip_ostreambuf &) = delete;
+	gzip_ostreambuf(gzip_ostreambuf &&) = delete;
+	auto operator=(const gzip_ostreambuf &) -> gzip_ostreambuf & = delete;
+	auto operator=(gzip_ostreambuf &&) -> gzip_ostreambuf & = delete;
+
+	~gzip_ostreambuf() override
+	{
+		deflateEnd(&m_stream);
+	}
+
+	/**
+	 * @brief Compresses the remaining data and writes the gzip trailer. Nothing may be
+	 * written afterwards.
+	 * @return `true` if all data reached the underlying stream.
+	 */
+	auto finish() -> bool
+	{
+		return deflate_pending(Z_FINISH);
+	}
+
+  protected:
+	auto overflow(int_type character) -> int_type override
+	{
+		if (!deflate_pending(Z_NO_FLUSH))
+		{
+			return traits_type::eof();
+		}
+		if (!traits_type::eq_int_type(character, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(character);
+			pbump(1);
+		}
+		return traits_type::not_eof(character);
+	}
+
+	auto sync() -> int override
+	{
+		// Flushing the compressor would hurt the ratio; finish() writes everything
+		return m_ok ? 0 : -1;
+	}
+
+  private:
+	std::ostream &m_sink;
+	std::vector<char> m_input;
+	std::vector<char> m_output;
+	z_stream m_stream{};
+	bool m_ok = false;
+
+	/**
+	 * @brief Deflates the buffered input and writes the produced output.
+	 */
+	auto deflate_pending(int flush) -> bool
+	{
+		if (!m_ok)
+		{
+			return false;
+		}
+		m_stream.next_in = reinterpret_cast<Bytef *>(pbase());
+		m_stream.avail_in = static_cast<uInt>(pptr() - pbase());
+		int status = Z_OK;
+		do
+		{
+			m_stream.next_out = reinterpret_cast<Bytef *>(m_output.data());
+			m_stream.avail_out = static_cast<uInt>(m_output.size());
+			status = deflate(&m_stream, flush);
+			if (status == Z_STREAM_ERROR)
+			{
+				m_ok = false;
+				return false;
+			}
+			m_sink.write(m_output.data(), static_cast<std::streamsize>(
+											  m_output.size() - m_stream.avail_out));
+			if (m_sink.fail())
+			{
+				m_ok = false;
+				return false;
+			}
+		} while (m_stream.avail_out == 0 ||
+				 (flush == Z_FINISH && status != Z_STREAM_END));
+		setp(m_input.data(), m_input.data() + m_input.size());
+		return true;
+	}
+};
+
+#endif
+
+/**
+ * @brief Identifies the exact INI source a sidecar cache was compiled from.
+ */
+struct sidecar_key
+{
+	std::uint64_t source_size;
+	std::int64_t source_mtime;
+	std::uint64_t source_hash;
+
+	auto operator==(const sidecar_key &) const -> bool = default;
+};
+
+/**
+ * @brief Header of a sidecar cache file; the binary image follows it.
+ */
+struct sidecar_header
+{
+	std::array<char, 8> magic;
+	sidecar_key key;
+};
+
+/**
+ * @brief Magic bytes opening every sidecar cache file.
+ */
+inline constexpr std::array<char, 8> sidecar_magic{'I', 'N', 'I', 'C',
+												   'A', 'C', 'H', 'E'};
+
+static_assert(sizeof(sidecar_header) == 32,
+			  "the binary image following the sidecar header must stay 8-byte aligned");
+
+/**
+ * @brief Kinds of meaningful lines in INI text.
+ */
+enum class line_kind : std::uint8_t
+{
+	none,
+	section,
+	entry,
+	include
+};
+
+/**
+ * @brief One classified line of INI text. For a section header `name` is the section
+ * name; for an entry it is the key and `value` the value; for an include directive it
+ * is the path.
+ */
+struct ini_line
+{
+	line_kind kind = line_kind::none;
+	std::string_view name;
+	std::string_view value;
+};
+
+/**
+ * @brief Classifies one line of INI text: blank lines, comments and unrecognized text
+ * are `line_kind::none`, as are entries with an empty key.
+ * @param line The line, with or without surrounding whitespace.
+ * @param directives Whether to recognize include directives; any other line starting
+ * with `!include` or `@include`, such as `@include_dir = /usr/include`, is classified
+ * like ordinary text.
+ * @return The classified line, viewing into `line`.
+ */
+constexpr auto classify_line(std::string_view line, bool directives = true) noexcept
+	-> ini_line
+{
+	const std::string_view line_view = trim(line);
+	if (line_view.empty() || line_view.starts_with(';') || line_view.starts_with('#'))
+	{
+		return {};
+	}
+
+	// Include directive: !include path or @include path, optionally quoted
+	if (directives &&
+		(line_view.starts_with("!include") || line_view.starts_with("@include")))
+	{
+		constexpr std::size_t directive_length = 8;
+		const auto rest = line_view.substr(directive_length);
+		auto path = trim(rest);
+		if (!rest.empty() && (rest.front() == ' ' || rest.front() == '\t') &&
+			!path.starts_with('='))
+		{
+			if (path.size() >= 2 && path.front() == '"' && path.back() == '"')
+			{
+				path = path.substr(1, path.size() - 2);
+			}
+			if (!path.empty())
+			{
+				return {line_kind::include, path, {}};
+			}
+		}
+	}
+
+	// Section header: [SectionName]; "[]" names the empty section
+	if (line_view.starts_with('[') && line_view.ends_with(']'))
+	{
+		const auto name = line_view.length() < 3
+							  ? std::string_view{}
+							  : trim(line_view.substr(1, line_view.length() - 2));
+		return {line_kind::section, name, {}};
+	}
+
+	// Key-value pair: Key = Value
+	if (const auto delimiter_pos = line_view.find('=');
+		delimiter_pos != std::string_view::npos)
+	{
+		const auto key = trim(line_view.substr(0, delimiter_pos));
+		if (!key.empty())
+		{
+			return {line_kind::entry, key, trim(line_view.substr(delimiter_pos + 1))};
+		}
+	}
+	return {};
+}
+
+/**
+ * @brief A classified line owning its text, as kept by the include cache.
+ */
+struct include_token
+{
+	line_kind kind;
+	std::string name;
+	std::string value;
+};
+
+/**
+ * @brief A file read through an include directive, tokenized once, together with the
+ * modification time and size it was read at.
+ */
+struct include_fragment
+{
+	std::filesystem::file_time_type mtime;
+	std::uintmax_t size;
+	std::vector<include_token> tokens;
+};
+
+/**
+ * @brief Magic word opening a patch made by `make_patch`.
+ */
+inline constexpr std::string_view patch_magic = "INIPATCH";
+
+/**
+ * @brief Version of the patch format.
+ */
+inline constexpr std::uint32_t patch_version = 2;
+
+/**
+ * @brief One operation of a patch. `code` is '[' to select a section, creating it if
+ * missing; ']' to remove a section; '=' to set a key of the selected section; '-' to
+ * remove a key of the selected section; '^' to declare the parent of the selected
+ * section, or remove the declaration if `name` is empty.
+ */
+struct patch_operation
+{
+	char code;
+	std::string_view name;
+	std::string_view value;
+};
+
+/**
+ * @brief A parsed patch, viewing into the patch text.
+ */
+struct parsed_patch
+{
+	ini::fingerprint128 base;
+	ini::fingerprint128 result;
+	std::vector<patch_operation> operations;
+};
+
+/**
+ * @brief Parses and validates a patch made by `make_patch`.
+ *
+ * The patch is one header line, `INIPATCH <version> <base> <result>` with both 128-bit
+ * fingerprints as 32 hexadecimal digits, high half first, followed by one line per
+ * operation: the operation code and its fields, each written as ` <length>:<bytes>` so
+ * any byte may appear in names and values.
+ * @param patch The patch text.
+ * @return A `std::expected` containing the operations on success, or a
+ * `std::error_code` on failure: `std::errc::not_supported` for another format version,
+ * `std::errc::invalid_argument` for malformed patches.
+ */
+inline auto parse_patch(std::string_view patch)
+	-> std::expected<parsed_patch, std::error_code>
+{
+	const auto malformed =
+		std::unexpected(std::make_error_code(std::errc::invalid_argument));
+	const auto header_end = patch.find('\n');
+	if (header_end == std::string_view::npos)
+	{
+		return malformed;
+	}
+	std::istringstream header{std::string{patch.substr(0, header_end)}};
+	std::string magic;
+	std::uint32_t version = 0;
+	std::string base;
+	std::string result;
+	header >> magic >> version >> base >> result;
+	if (header.fail() || magic != patch_magic)
+	{
+		return malformed;
+	}
+	if (version != patch_version)
+	{
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+	}
+	const auto read_fingerprint = [](std::string_view text,
+									 ini::fingerprint128 &fingerprint) {
+		constexpr std::size_t half = 16;
+		const auto read_half = [](std::string_view digits, std::uint64_t &value) {
+			const auto [end, error] =
+				std::from_chars(digits.data(), digits.data() + digits.size(), value, 16);
+			return error == std::errc{} && end == digits.data() + digits.size();
+		};
+		return text.size() == 2 * half &&
+			   read_half(text.substr(0, half), fingerprint.high) &&
+			   read_half(text.substr(half), fingerprint.low);
+	};
+	parsed_patch parsed{};
+	if (!read_fingerprint(base, parsed.base) || !read_fingerprint(result, parsed.result))
+	{
+		return malformed;
+	}
+
+	std::size_t position = header_end + 1;
+	const auto read_field = [&patch, &position]() -> std::optional<std::string_view> {
+		if (position >= patch.size() || patch[position] != ' ')
+		{
+			return std::nullopt;
+		}
+		const auto *const first = patch.data() + position + 1;
+		const auto *const last = patch.data() + patch.size();
+		std::size_t length = 0;
+		const auto [colon, error] = std::from_chars(first, last, length);
+		if (error != std::errc{} || colon == last || *colon != ':' ||
+			static_cast<std::size_t>(last - colon - 1) < length)
+		{
+			return std::nullopt;
+		}
+		position = static_cast<std::size_t>(colon + 1 - patch.data()) + length;
+		return std::string_view{colon + 1, length};
+	};
+
+	bool selected = false;
+	while (position < patch.size())
+	{
+		patch_operation operation{patch[position++], {}, {}};
+		const auto name = read_field();
+		if (!name.has_value())
+		{
+			return malformed;
+		}
+		operation.name = *name;
+		switch (operation.code)
+		{
+		case '[':
+			selected = true;
+			break;
+		case ']':
+			selected = false;
+			break;
+		case '=':
+			if (const auto value = read_field(); value.has_value() && selected)
+			{
+				operation.value = *value;
+				break;
+			}
+			return malformed;
+		case '-':
+		case '^':
+			if (selected)
+			{
+				break;
+			}
+			return malformed;
+		default:
+			return malformed;
+		}
+		if (position >= patch.size() || patch[position++] != '\n')
+		{
+			return malformed;
+		}
+		parsed.operations.push_back(operation);
+	}
+	return parsed;
+}
+
+} // namespace detail
+
+class ini_manager;
+
+/**
+ * @brief Compression of INI files.
+ */
+enum class compression : std::uint8_t
+{
+	/**
+	 * @brief Loading decompresses gzip data, recognized by its magic bytes; writing
+	 * compresses with gzip when the path ends with ".gz".
+	 */
+	detect,
+	/**
+	 * @brief Plain text.
+	 */
+	none,
+	/**
+	 * @brief gzip-compressed text.
+	 */
+	gzip
+};
+
+/**
+ * @brief Cache of files read through include directives.
+ *
+ * Every file is read and tokenized once and reused while its modification time and
+ * size are unchanged. Each load keeps its own cache, so a fragment included from many
+ * files is read once per load; pass a shared cache in `load_options` to also reuse
+ * fragments across loads. Safe to share between threads.
+ */
+class include_cache
+{
+  public:
+	/**
+	 * @brief Gets the number of cached files.
+	 * @return The number of cached files.
+	 */
+	auto size() const -> std::size_t
+	{
+		const std::scoped_lock lock{m_mutex};
+		return m_fragments.size();
+	}
+
+	/**
+	 * @brief Drops every cached file.
+	 */
+	void clear()
+	{
+		const std::scoped_lock lock{m_mutex};
+		m_fragments.clear();
+	}
+
+  private:
+	friend class ini_manager;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, std::shared_ptr<const detail::include_fragment>>
+		m_fragments;
+
+	/**
+	 * @brief Looks up a file read at the given modification time and size.
+	 */
+	auto find(const std::string &path, std::filesystem::file_time_type mtime,
+			  std::uintmax_t size) const
+		-> std::shared_ptr<const detail::include_fragment>
+	{
+		const std::scoped_lock lock{m_mutex};
+		const auto found = m_fragments.find(path);
+		if (found == m_fragments.end() || found->second->mtime != mtime ||
+			found->second->size != size)
+		{
+			return nullptr;
+		}
+		return found->second;
+	}
+
+	/**
+	 * @brief Stores a freshly read file, replacing any stale version.
+	 */
+	void store(const std::string &path,
+			   std::shared_ptr<const detail::include_fragment> fragment)
+	{
+		const std::scoped_lock lock{m_mutex};
+		m_fragments.insert_or_assign(path, std::move(fragment));
+	}
+};
+
+/**
+ * @brief Options controlling how INI data is loaded from files.
+ */
+struct load_options
+{
+	/**
+	 * @brief Keep a compiled cache next to the file (`<file_path>.inicache`).
+	 *
+	 * While the cache matches the file's size, modification time and content hash, the
+	 * data is loaded from it without parsing any text. Otherwise the file is parsed
+	 * and the cache is atomically replaced. Any cache failure falls back to parsing.
+	 */
+	bool sidecar_cache = false;
+
+	/**
+	 * @brief Honor `!include path` and `@include path` directives.
+	 *
+	 * The named file is parsed in place of the directive: it starts in the section of
+	 * the directive, and the including file continues in that same section afterwards.
+	 * Relative paths are resolved against the directory of the including file, or the
+	 * working directory for streams. Including a file that is already being included
+	 * fails with `std::errc::too_many_symbolic_link_levels`. Off by default, since it
+	 * lets the text open arbitrary files; when disabled, directive lines are read as
+	 * ordinary text, so `!include = x` is an entry and `!include x` is ignored.
+	 */
+	bool includes = false;
+
+	/**
+	 * @brief Cache of included files to reuse across loads; each load uses a private
+	 * one when unset.
+	 */
+	std::shared_ptr<ini::include_cache> shared_include_cache{};
+
+	/**
+	 * @brief Compression of the loaded data, included files alike.
+	 *
+	 * gzip data is inflated block by block straight into the parser, never holding the
+	 * whole decompressed text. Requires a build with `ini_manager_WITH_ZLIB`; loading
+	 * gzip data fails with `std::errc::not_supported` otherwise.
+	 */
+	ini::compression compression = ini::compression::detect;
+
+	/**
+	 * @brief Maintain the dotted section tree index, see
+	 * `ini_manager::enable_section_tree`.
+	 */
+	bool section_tree = false;
+
+	/**
+	 * @brief Maintain the reverse value index, see `ini_manager::enable_value_index`.
+	 */
+	bool value_index = false;
+
+	/**
+	 * @brief Maintain the Bloom filter of keys, see `ini_manager::enable_key_filter`.
+	 */
+	bool key_filter = false;
+
+	/**
+	 * @brief Read `[section : parent]` headers as section inheritance, see
+	 * `ini_manager::set_parent`.
+	 *
+	 * Declaring a parent that descends from the section fails the load with
+	 * `std::errc::too_many_symbolic_link_levels`. When disabled, the whole text between
+	 * the brackets is the section name, so enable it to read back what `write_file`
+	 * wrote for sections declaring a parent; a section whose own name holds a colon
+	 * then reads back split in two. The sidecar cache holds no parent declarations and
+	 * is not used with this option.
+	 */
+	bool inheritance = false;
+};
+
+namespace detail
+{
+
+/**
+ * @brief The typed read API of a configuration, built on its `get_value_view`.
+ *
+ * Configurations derive from it with themselves as `Derived`, which must provide
+ * `get_value_view(section, key)` returning `std::optional<std::string_view>`. The
+ * functions are `noexcept` whenever `get_value_view` is.
+ * @tparam Derived The configuration class.
+ */
+template <typename Derived> class value_reader
+{
+  public:
+	/**
+	 * @brief Retrieves a string value for a given section and key.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing the string value,
+	 * or `std::nullopt` if the section or key does not exist.
+	 */
+	auto get_value(section section, key key) const noexcept(nothrow_view())
+		-> std::optional<std::string>
+	{
+		if (const auto value = self().get_value_view(section, key); value.has_value())
+		{
+			return std::string{*value};
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Retrieves a value of a specific type for a given section and key.
+	 * @tparam T The type of the value to retrieve. Must be `std::string`, `bool`,
+	 * or satisfy the `StreamExtractable` concept.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing the value of type `T`,
+	 * or `std::nullopt` if the section or key does not exist, or if the
+	 * value cannot be converted to the requested type.
+	 */
+	template <typename T>
+	auto get_value(section section, key key) const noexcept(nothrow_view())
+		-> std::optional<T>
+	{
+		if (const auto value = self().get_value_view(section, key); value.has_value())
+		{
+			return convert_value<T>(*value);
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Retrieves a string value for a given section and key, or a default value if
+	 * not found.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @param default_value The value to return if the section or key does not exist.
+	 * @return The string value associated with the key, or the default value.
+	 */
+	auto get_value_or_default(section section, key key, std::string default_value) const
+		noexcept(nothrow_view()) -> std::string
+	{
+		return get_value(section, key).value_or(std::move(default_value));
+	}
+
+	/**
+	 * @brief Retrieves a value of a specific type for a given section and key,
+	 * or a default value if not found.
+	 * @tparam T The type of the value to retrieve.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @param default_value The value to return if the section or key does not exist,
+	 * or if the value cannot be converted to the requested type.
+	 * @return The value of type `T` associated with the key, or the default value.
+	 */
+	template <typename T>
+	auto get_value_or_default(section section, key key, T default_value) const
+		noexcept(nothrow_view()) -> T
+	{
+		return get_value<T>(section, key).value_or(std::move(default_value));
+	}
+
+  private:
+	static constexpr auto nothrow_view() noexcept -> bool
+	{
+		return noexcept(std::declval<const Derived &>().get_value_view(
+			std::declval<section>(), std::declval<key>()));
+	}
+
+	auto self() const noexcept -> const Derived &
+	{
+		return static_cast<const Derived &>(*this);
+	}
+};
+
+} // namespace detail
+
+/**
+ * @brief Read-only view of a compiled binary INI image.
+ *
+ * Loading maps the image into memory and validates its header; every lookup is then
+ * served directly from the mapped pages through a hashed key index, without parsing
+ * or building any in-memory containers. Copies share the same mapping.
+ */
+class binary_config : public detail::value_reader<binary_config>
+{
+  public:
+	/**
+	 * @brief Opens a compiled binary INI file written by `ini_manager::save_binary`.
+	 * @param file_path The path to the binary file.
+	 * @param verify_checksum Whether to check the image checksum. This reads every
+	 * page of the file; pass `false` to keep loading O(1) for trusted files.
+	 * @return A `std::expected` containing the binary_config object on success,
+	 * or a `std::error_code` on failure: `std::errc::invalid_argument` for a malformed
+	 * image, `std::errc::not_supported` for an incompatible version or byte order and
+	 * `std::errc::bad_message` for a checksum mismatch.
+	 */
+	static auto from_binary(const std::string &file_path, bool verify_checksum = true)
+		-> std::expected<binary_config, std::error_code>
+	{
+		auto mapping = detail::mapped_file::open(file_path);
+		if (!mapping.has_value())
+		{
+			return std::unexpected(mapping.error());
+		}
+		const auto image = (*mapping)->bytes();
+		return from_memory(std::move(*mapping), image, verify_checksum);
+	}
+
+	/**
+	 * @brief Wraps a binary image that is already in memory, e.g. in a shared memory
+	 * segment. Only the header and the table bounds are checked, so this is O(1)
+	 * unless the checksum is verified.
+	 * @param owner Keeps the memory behind `image` alive for as long as the
+	 * binary_config object or any of its copies exist.
+	 * @param image The image bytes.
+	 * @param verify_checksum Whether to check the image checksum.
+	 * @return A `std::expected` containing the binary_config object on success,
+	 * or a `std::error_code` on failure, as for `from_binary`.
+	 */
+	static auto from_memory(std::shared_ptr<const void> owner,
+							std::span<const std::byte> image, bool verify_checksum = true)
+		-> std::expected<binary_config, std::error_code>
+	{
+		const auto invalid =
+			std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		if (image.size() < sizeof(detail::binary_header))
+		{
+			return invalid;
+		}
+
+		binary_config config;
+		std::memcpy(&config.m_header, image.data(), sizeof(detail::binary_header));
+		const auto &header = config.m_header;
+		if (header.magic != detail::binary_magic)
+		{
+			return invalid;
+		}
+		if (header.endian_tag != detail::binary_endian_tag ||
+			header.version != detail::binary_version)
+		{
+			return std::unexpected(std::make_error_code(std::errc::not_supported));
+		}
+
+		// Every table must lie inside the image; the divisions keep this overflow-free
+		const auto fits = [&header](std::uint64_t offset, std::uint64_t count,
+									std::uint64_t element_size) {
+			return offset <= header.image_size &&
+				   count <= (header.image_size - offset) / element_size;
+		};
+		if (header.image_size > image.size() ||
+			!fits(header.sections_offset, header.section_count,
+				  sizeof(detail::binary_section)) ||
+			!fits(header.entries_offset, header.entry_count,
+				  sizeof(detail::binary_entry)) ||
+			!fits(header.buckets_offset, header.bucket_count, sizeof(std::uint64_t)) ||
+			!fits(header.strings_offset, header.strings_size, 1) ||
+			(header.bucket_count & (header.bucket_count - 1)) != 0 ||
+			(header.entry_count != 0 && header.bucket_count < header.entry_count))
+		{
+			return invalid;
+		}
+
+		config.m_owner = std::move(owner);
+		config.m_image = image.first(header.image_size);
+		if (verify_checksum && !config.verify())
+		{
+			return std::unexpected(std::make_error_code(std::errc::bad_message));
+		}
+		return config;
+	}
+
+	/**
+	 * @brief Retrieves a string value for a given section and key without copying it.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing a view into the mapped image,
+	 * or `std::nullopt` if the section or key does not exist.
+	 */
+	auto get_value_view(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		if (m_header.bucket_count == 0)
+		{
+			return std::nullopt;
+		}
+		const auto hash = detail::hash_entry(section.value, key.value);
+		const auto mask = m_header.bucket_count - 1;
+		auto slot = hash & mask;
+		for (std::uint64_t probe = 0; probe < m_header.bucket_count; ++probe)
+		{
+			const auto stored = read<std::uint64_t>(m_header.buckets_offset +
+													slot * sizeof(std::uint64_t));
+			if (stored == 0 || stored > m_header.entry_count)
+			{
+				return std::nullopt;
+			}
+			const auto entry = entry_at(stored - 1);
+			if (entry.hash == hash && entry.section < m_header.section_count &&
+				string_at(entry.key) == key.value &&
+				string_at(section_at(entry.section).name) == section.value)
+			{
+				return string_at(entry.value);
+			}
+			slot = (slot + 1) & mask;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Gets a list of all section names in the image.
+	 * @return A `std::vector` containing the names of all sections, in alphabetical
+	 * order.
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		std::vector<std::string> names;
+		names.reserve(m_header.section_count);
+		for (std::uint64_t index = 0; index < m_header.section_count; ++index)
+		{
+			names.emplace_back(string_at(section_at(index).name));
+		}
+		return names;
+	}
+
+	/**
+	 * @brief Gets a list of all key names within a specific section.
+	 * @param section The section whose keys are to be retrieved.
+	 * @return A `std::vector` containing the names of all keys in the specified section,
+	 * in alphabetical order. Returns an empty vector if the section does not exist.
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		std::vector<std::string> names;
+		if (const auto record = find_section(section.value); record.has_value())
+		{
+			const auto last = std::min(record->first_entry + record->entry_count,
+									   m_header.entry_count);
+			for (auto index = record->first_entry; index < last; ++index)
+			{
+				names.emplace_back(string_at(entry_at(index).key));
+			}
+		}
+		return names;
+	}
+
+	/**
+	 * @brief Recomputes the image checksum and compares it with the stored one.
+	 * @return `true` if the image is intact, `false` otherwise.
+	 */
+	auto verify() const noexcept -> bool
+	{
+		return detail::binary_checksum(m_header, m_image.first(m_header.image_size)) ==
+			   m_header.checksum;
+	}
+
+  private:
+	friend class ini_manager;
+
+	std::shared_ptr<const void> m_owner;
+	std::span<const std::byte> m_image;
+	detail::binary_header m_header{};
+
+	/**
+	 * @brief Reads a trivially copyable record from the image.
+	 */
+	template <typename T> auto read(std::uint64_t offset) const noexcept -> T
+	{
+		T value;
+		std::memcpy(&value, m_image.data() + offset, sizeof(T));
+		return value;
+	}
+
+	auto section_at(std::uint64_t index) const noexcept -> detail::binary_section
+	{
+		return read<detail::binary_section>(m_header.sections_offset +
+											index * sizeof(detail::binary_section));
+	}
+
+	auto entry_at(std::uint64_t index) const noexcept -> detail::binary_entry
+	{
+		return read<detail::binary_entry>(m_header.entries_offset +
+										  index * sizeof(detail::binary_entry));
+	}
+
+	/**
+	 * @brief Resolves a string reference; out-of-bounds references yield an empty view.
+	 */
+	auto string_at(detail::binary_string ref) const noexcept -> std::string_view
+	{
+		if (ref.offset > m_header.strings_size ||
+			ref.size > m_header.strings_size - ref.offset)
+		{
+			return {};
+		}
+		return detail::as_chars(m_image).substr(m_header.strings_offset + ref.offset,
+												ref.size);
+	}
+
+	/**
+	 * @brief Binary searches the name-sorted section table.
+	 */
+	auto find_section(std::string_view name) const noexcept
+		-> std::optional<detail::binary_section>
+	{
+		std::uint64_t first = 0;
+		std::uint64_t last = m_header.section_count;
+		while (first < last)
+		{
+			const auto middle = first + (last - first) / 2;
+			const auto record = section_at(middle);
+			const auto order = string_at(record.name) <=> name;
+			if (order == 0)
+			{
+				return record;
+			}
+			if (order < 0)
+			{
+				first = middle + 1;
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+		return std::nullopt;
+	}
+};
+
+/**
+ * @brief A glob pattern over section or key names, compiled once and matched many
+ * times.
+ *
+ * `*` matches any run of characters, `?` any single character, `[abc]` and `[a-z]`
+ * one character of a set, `[!abc]` one character outside it, and `\` makes the next
+ * character literal. The pattern must match the whole name. Compilation splits the
+ * pattern into literal runs, single-character tests and stars, so matching compares
+ * runs of bytes instead of interpreting the pattern, and only backtracks to the last
+ * star. The literal text before the first wildcard lets ordered queries skip every
+ * name without that prefix.
+ */
+class glob
+{
+  public:
+	/**
+	 * @brief Compiles a glob pattern.
+	 * @param pattern The pattern, e.g. `tenant-*` or `*.timeout_ms`.
+	 * @return A `std::expected` containing the compiled pattern on success, or
+	 * `std::errc::invalid_argument` for an unterminated `[` set or a trailing `\`.
+	 */
+	static auto compile(std::string_view pattern) -> std::expected<glob, std::error_code>
+	{
+		const auto malformed =
+			std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		glob compiled;
+		compiled.m_pattern = pattern;
+		const auto append_literal = [&compiled](char character) {
+			if (compiled.m_tokens.empty() ||
+				compiled.m_tokens.back().kind != token_kind::literal)
+			{
+				compiled.m_tokens.push_back(
+					{token_kind::literal, compiled.m_literals.size(), 0});
+			}
+			compiled.m_literals += character;
+			++compiled.m_tokens.back().size;
+		};
+
+		for (std::size_t position = 0; position < pattern.size(); ++position)
+		{
+			const char character = pattern[position];
+			switch (character)
+			{
+			case '*':
+				// Consecutive stars match the same as one
+				if (compiled.m_tokens.empty() ||
+					compiled.m_tokens.back().kind != token_kind::any_run)
+				{
+					compiled.m_tokens.push_back({token_kind::any_run, 0, 0});
+				}
+				break;
+			case '?':
+				compiled.m_tokens.push_back({token_kind::any_one, 0, 0});
+				break;
+			case '[': {
+				auto set = parse_set(pattern, position);
+				if (!set.has_value())
+				{
+					return malformed;
+				}
+				compiled.m_tokens.push_back({token_kind::set, compiled.m_sets.size(), 0});
+				compiled.m_sets.push_back(*set);
+				break;
+			}
+			case '\\':
+				if (++position == pattern.size())
+				{
+					return malformed;
+				}
+				append_literal(pattern[position]);
+				break;
+			default:
+				append_literal(character);
+				break;
+			}
+		}
+
+		if (!compiled.m_tokens.empty() &&
+			compiled.m_tokens.front().kind == token_kind::literal)
+		{
+			compiled.m_prefix_size = compiled.m_tokens.front().size;
+		}
+		return compiled;
+	}
+
+	/**
+	 * @brief Checks whether a name matches the pattern.
+	 * @param name The section or key name.
+	 * @return `true` if the whole name matches.
+	 */
+	auto matches(std::string_view name) const noexcept -> bool
+	{
+		std::size_t next = 0;
+		std::size_t position = 0;
+		// Where to resume after a mismatch: the token after the last star, and the
+		// position that star's run extends to
+		std::size_t star = m_tokens.size();
+		std::size_t star_position = 0;
+		while (next < m_tokens.size() || position < name.size())
+		{
+			if (next < m_tokens.size() && step(m_tokens[next], name, position))
+			{
+				if (m_tokens[next].kind == token_kind::any_run)
+				{
+					star = next;
+					star_position = position;
+				}
+				++next;
+				continue;
+			}
+			if (star == m_tokens.size() || star_position == name.size())
+			{
+				return false;
+			}
+			next = star + 1;
+			position = ++star_position;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Gets the literal text every matching name starts with.
+	 * @return The prefix, empty if the pattern starts with a wildcard.
+	 */
+	auto literal_prefix() const noexcept -> std::string_view
+	{
+		return std::string_view{m_literals}.substr(0, m_prefix_size);
+	}
+
+	/**
+	 * @brief Gets the pattern the glob was compiled from.
+	 * @return The pattern.
+	 */
+	auto pattern() const noexcept -> const std::string &
+	{
+		return m_pattern;
+	}
+
+  private:
+	enum class token_kind : std::uint8_t
+	{
+		literal,
+		any_one,
+		any_run,
+		set
+	};
+
+	/**
+	 * @brief One compiled step: a literal run (`m_literals[index, index + size)`), a
+	 * set (`m_sets[index]`), any one character or a star.
+	 */
+	struct token
+	{
+		token_kind kind;
+		std::size_t index;
+		std::size_t size;
+	};
+
+	using character_set = std::bitset<256>;
+
+	std::string m_pattern;
+	std::string m_literals;
+	std::vector<character_set> m_sets;
+	std::vector<token> m_tokens;
+	std::size_t m_prefix_size = 0;
+
+	glob() = default;
+
+	/**
+	 * @brief Parses a `[...]` set starting at `position`, leaving `position` on its
+	 * closing `]`.
+	 */
+	static auto parse_set(std::string_view pattern, std::size_t &position)
+		-> std::optional<character_set>
+	{
+		character_set set;
+		auto cursor = position + 1;
+		const bool negated =
+			cursor < pattern.size() && (pattern[cursor] == '!' || pattern[cursor] == '^');
+		cursor += negated ? 1 : 0;
+		// A `]` right after the opening bracket is a member, not the end
+		for (auto first = cursor; cursor < pattern.size(); ++cursor)
+		{
+			if (pattern[cursor] == ']' && cursor != first)
+			{
+				position = cursor;
+				return negated ? ~set : set;
+			}
+			const auto low = static_cast<unsigned char>(pattern[cursor]);
+			auto high = low;
+			if (cursor + 2 < pattern.size() && pattern[cursor + 1] == '-' &&
+				pattern[cursor + 2] != ']')
+			{
+				high = static_cast<unsigned char>(pattern[cursor + 2]);
+				cursor += 2;
+			}
+			for (unsigned member = low; member <= high; ++member)
+			{
+				set.set(member);
+			}
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Matches one token at `position`, advancing past what it consumed. A star
+	 * consumes nothing at first; mismatches later extend its run.
+	 */
+	auto step(const token &current, std::string_view name, std::size_t &position) const
+		noexcept -> bool
+	{
+		switch (current.kind)
+		{
+		case token_kind::literal:
+			if (name.substr(position).starts_with(
+					std::string_view{m_literals}.substr(current.index, current.size)))
+			{
+				position += current.size;
+				return true;
+			}
+			return false;
+		case token_kind::any_one:
+		case token_kind::set:
+			if (position < name.size() &&
+				(current.kind == token_kind::any_one ||
+				 m_sets[current.index].test(static_cast<unsigned char>(name[position]))))
+			{
+				++position;
+				return true;
+			}
+			return false;
+		case token_kind::any_run:
+			return true;
+		}
+		return false;
+	}
+};
+
+namespace detail
+{
+
+/**
+ * @brief Keeps the names matching a glob, as the predicate of a filter view.
+ */
+struct glob_filter
+{
+	glob pattern;
+
+	auto operator()(std::string_view name) const noexcept -> bool
+	{
+		return pattern.matches(name);
+	}
+};
+
+/**
+ * @brief Memoized results of `ini_manager::get_interpolated`, with reverse dependency
+ * edges so that a change invalidates exactly the results built from it.
+ *
+ * Entries are identified by `hash_entry(section, key)`. Results also keep their names,
+ * so a hash collision can only cause an extra invalidation, never a wrong value.
+ */
+struct interpolation_cache
+{
+	struct result
+	{
+		std::string section;
+		std::string key;
+		std::string value;
+	};
+
+	std::mutex mutex;
+	std::unordered_map<std::uint64_t, result> results;
+	/**
+	 * @brief For each entry, the results that read it through a reference.
+	 */
+	std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> dependents;
+
+	/**
+	 * @brief Finds the memoized result of an entry.
+	 * @return The result, or `nullptr` if it is not memoized.
+	 */
+	auto find(std::uint64_t id, std::string_view section, std::string_view key) const
+		-> const std::string *
+	{
+		const auto found = results.find(id);
+		if (found == results.end() || found->second.section != section ||
+			found->second.key != key)
+		{
+			return nullptr;
+		}
+		return &found->second.value;
+	}
+
+	/**
+	 * @brief Memoizes the result of an entry and the entries it was built from.
+	 */
+	void store(std::uint64_t id, result value, const std::vector<std::uint64_t> &sources)
+	{
+		results.insert_or_assign(id, std::move(value));
+		for (const auto source : sources)
+		{
+			auto &edges = dependents[source];
+			if (std::ranges::find(edges, id) == edges.end())
+			{
+				edges.push_back(id);
+			}
+		}
+	}
+
+	/**
+	 * @brief Drops the result of an entry about to change, and of everything built
+	 * from it, transitively.
+	 */
+	void invalidate(std::uint64_t id)
+	{
+		std::vector<std::uint64_t> pending{id};
+		while (!pending.empty())
+		{
+			const auto current = pending.back();
+			pending.pop_back();
+			results.erase(current);
+			if (const auto found = dependents.find(current); found != dependents.end())
+			{
+				pending.insert(pending.end(), found->second.begin(), found->second.end());
+				dependents.erase(found);
+			}
+		}
+	}
+};
+
+/**
+ * @brief A blocked Bloom filter of `hash_entry(section, key)` hashes, answering "this
+ * key is certainly absent" without touching the section and key maps.
+ *
+ * All bits of one hash fall into the same 64-byte block, so a query reads a single
+ * cache line. Removed keys cannot be cleared from the bits; `stale` counts them until
+ * the owner rebuilds the filter.
+ */
+struct key_filter
+{
+	/**
+	 * @brief The bits reserved per key, for a false positive rate of about 0.2%.
+	 */
+	static constexpr std::size_t bits_per_key = 16;
+	static constexpr std::size_t block_words = 8;
+
+	std::vector<std::uint64_t> words;
+	/**
+	 * @brief The keys present.
+	 */
+	std::size_t keys = 0;
+	/**
+	 * @brief The keys removed since the last rebuild, whose bits are still set.
+	 */
+	std::size_t stale = 0;
+
+	/**
+	 * @brief Clears the filter and sizes it for a number of keys.
+	 */
+	void reset(std::size_t capacity)
+	{
+		const auto blocks =
+			std::bit_ceil(std::max<std::size_t>(1, capacity * bits_per_key / 512));
+		words.assign(blocks * block_words, 0);
+		keys = 0;
+		stale = 0;
+	}
+
+	void insert(std::uint64_t hash) noexcept
+	{
+		auto *block = &words[block_of(hash)];
+		auto bits = hash >> 28U;
+		for (int probe = 0; probe < 4; ++probe, bits >>= 9U)
+		{
+			block[(bits >> 6U) & 7U] |= std::uint64_t{1} << (bits & 63U);
+		}
+	}
+
+	auto may_contain(std::uint64_t hash) const noexcept -> bool
+	{
+		const auto *block = &words[block_of(hash)];
+		auto bits = hash >> 28U;
+		for (int probe = 0; probe < 4; ++probe, bits >>= 9U)
+		{
+			if ((block[(bits >> 6U) & 7U] & (std::uint64_t{1} << (bits & 63U))) == 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Checks whether the filter is too small for its keys or too polluted by
+	 * removed ones to stay selective.
+	 */
+	auto needs_rebuild() const noexcept -> bool
+	{
+		return (keys + stale) * bits_per_key > words.size() * 64 || stale > keys;
+	}
+
+  private:
+	auto block_of(std::uint64_t hash) const noexcept -> std::size_t
+	{
+		// The low bits pick the block, the 36 bits above the 28th place the probes
+		return static_cast<std::size_t>(hash) & (words.size() - block_words);
+	}
+};
+
+} // namespace detail
+
+/**
+ * @brief Manages INI file data, allowing reading, writing, and manipulation of
+ * configuration settings.
+ */
+class ini_manager
+{
+	// Define the underlying data map types for brevity
+	using entry_map = std::map<std::string, std::string, std::less<>>;
+
+	/**
+	 * @brief The keys and values of one section, with the summaries kept for it. It
+	 * reads like a plain map; changes go through `storage`.
+	 */
+	struct section_data : entry_map
+	{
+		/**
+		 * @brief The seeds of the fingerprints of the section's entries.
+		 */
+		ini::fingerprint128 seeds;
+		/**
+		 * @brief The fingerprint of the section: its own contribution plus those of
+		 * its entries.
+		 */
+		ini::fingerprint128 fingerprint;
+		/**
+		 * @brief The section lookups fall through to, empty if none is declared.
+		 */
+		std::string parent;
+		/**
+		 * @brief The existing ancestors of the section, nearest first. Resolved by
+		 * `storage` whenever sections are added, removed or re-parented, so that
+		 * lookups neither lock nor allocate.
+		 */
+		std::vector<const std::pair<const std::string, section_data> *> ancestors;
+	};
+
+	using data_map = std::map<std::string, section_data, std::less<>>;
+
+	/**
+	 * @brief The INI data together with the summaries maintained alongside it.
+	 *
+	 * Every change goes through its member functions, which update the summaries in
+	 * proportion to the change, so reading a summary is O(1).
+	 */
+	class storage
+	{
+	  public:
+		/**
+		 * @brief A node of the section tree: one dot-separated component of section
+		 * names, e.g. `cache` in `[service.cache.l1]`.
+		 */
+		struct tree_node
+		{
+			std::map<std::string, tree_node, std::less<>> children;
+			/**
+			 * @brief The section named by the path to this node, or `nullptr` if the
+			 * node only leads to deeper sections.
+			 */
+			const data_map::value_type *section = nullptr;
+		};
+
+		/**
+		 * @brief Where a value is stored: the names of its section and key, which stay
+		 * in place in the maps until the entry is removed.
+		 */
+		struct value_location
+		{
+			const std::string *section;
+			const std::string *key;
+		};
+
+		using value_index = std::unordered_map<std::string, std::vector<value_location>,
+											   detail::string_hash, std::equal_to<>>;
+
+		/**
+		 * @brief The existing ancestors of a section, nearest first.
+		 */
+		using ancestor_list = decltype(section_data::ancestors);
+
+		/**
+		 * @brief Gets the sections, in alphabetical order.
+		 */
+		auto sections() const noexcept -> const data_map &
+		{
+			return m_sections;
+		}
+
+		/**
+		 * @brief Gets the counts summarizing the sections.
+		 */
+		auto stats() const noexcept -> ini::statistics
+		{
+			ini::statistics stats;
+			stats.sections = m_sections.size();
+			stats.keys = m_keys;
+			stats.payload_bytes = m_bytes;
+			if (m_largest_stale.load(std::memory_order_acquire))
+			{
+				// Concurrent readers find the same section, so either store will do
+				const data_map::value_type *largest = nullptr;
+				for (const auto &section : m_sections)
+				{
+					if (largest == nullptr ||
+						section.second.size() > largest->second.size())
+					{
+						largest = &section;
+					}
+				}
+				m_largest.store(largest, std::memory_order_relaxed);
+				m_largest_stale.store(false, std::memory_order_release);
+			}
+			if (const auto *largest = m_largest.load(std::memory_order_relaxed))
+			{
+				stats.largest_section = largest->first;
+				stats.largest_section_keys = largest->second.size();
+			}
+			return stats;
+		}
+
+		/**
+		 * @brief Gets the fingerprint of all sections.
+		 */
+		auto fingerprint() const noexcept -> ini::fingerprint128
+		{
+			return m_fingerprint;
+		}
+
+		/**
+		 * @brief Gets the root of the section tree, or `nullptr` if it is not
+		 * maintained.
+		 */
+		auto tree() const noexcept -> const tree_node *
+		{
+			return m_tree.get();
+		}
+
+		/**
+		 * @brief Starts maintaining the section tree, building it from the current
+		 * sections.
+		 */
+		void enable_tree()
+		{
+			if (m_tree)
+			{
+				return;
+			}
+			m_tree = std::make_unique<tree_node>();
+			for (const auto &section : m_sections)
+			{
+				link(section);
+			}
+		}
+
+		/**
+		 * @brief Gets the reverse value index, or `nullptr` if it is not maintained.
+		 */
+		auto values() const noexcept -> const value_index *
+		{
+			return m_values.get();
+		}
+
+		/**
+		 * @brief Starts maintaining the reverse value index, building it from the
+		 * current entries.
+		 */
+		void enable_value_index()
+		{
+			if (m_values)
+			{
+				return;
+			}
+			m_values = std::make_unique<value_index>();
+			for (const auto &section : m_sections)
+			{
+				for (const auto &entry : section.second)
+				{
+					index(section.first, entry);
+				}
+			}
+		}
+
+		/**
+		 * @brief Gets the Bloom filter of keys, or `nullptr` if it is not maintained.
+		 */
+		auto key_filter() const noexcept -> const detail::key_filter *
+		{
+			return m_filter.get();
+		}
+
+		/**
+		 * @brief Starts maintaining the Bloom filter of keys, building it from the
+		 * current entries.
+		 */
+		void enable_key_filter()
+		{
+			if (m_filter)
+			{
+				return;
+			}
+			m_filter = std::make_unique<detail::key_filter>();
+			rebuild_filter();
+		}
+
+		/**
+		 * @brief Gets the memoized interpolation results, creating them on first use.
+		 */
+		auto interpolations() -> detail::interpolation_cache &
+		{
+			// Concurrent readers may get here first at the same time
+			std::call_once(m_interpolations_created, [this] {
+				m_interpolations = std::make_unique<detail::interpolation_cache>();
+			});
+			return *m_interpolations;
+		}
+
+		/**
+		 * @brief Starts maintaining the optional indexes requested by load options.
+		 */
+		void enable_indexes(const load_options &options)
+		{
+			if (options.section_tree)
+			{
+				enable_tree();
+			}
+			if (options.value_index)
+			{
+				enable_value_index();
+			}
+			if (options.key_filter)
+			{
+				enable_key_filter();
+			}
+		}
+
+		/**
+		 * @brief Starts maintaining the optional indexes other storage maintains.
+		 */
+		void enable_indexes(const storage &other)
+		{
+			if (other.m_tree)
+			{
+				enable_tree();
+			}
+			if (other.m_values)
+			{
+				enable_value_index();
+			}
+			if (other.m_filter)
+			{
+				enable_key_filter();
+			}
+		}
+
+		/**
+		 * @brief Finds a section without allocating.
+		 */
+		auto find(std::string_view section) const -> data_map::const_iterator
+		{
+			return m_sections.find(section);
+		}
+
+		/**
+		 * @brief Finds a section, creating it empty if it does not exist.
+		 */
+		auto ensure_section(std::string_view section) -> data_map::iterator
+		{
+			auto found = m_sections.lower_bound(section);
+			if (found != m_sections.end() && found->first == section)
+			{
+				return found;
+			}
+			found = m_sections.emplace_hint(found, std::string{section}, section_data{});
+			found->second.seeds = detail::section_seeds(section);
+			found->second.fingerprint = detail::section_fingerprint(section);
+			m_fingerprint += found->second.fingerprint;
+			m_bytes += section.size();
+			grown(*found);
+			if (m_tree)
+			{
+				link(*found);
+			}
+			// A declared parent may have just come into existence
+			for (auto [child, last] = m_children.equal_range(section); child != last;
+				 ++child)
+			{
+				resolve_ancestors(*child->second);
+			}
+			return found;
+		}
+
+		/**
+		 * @brief Declares the parent of a section, creating the section as needed.
+		 */
+		void set_parent(std::string_view section, std::string parent)
+		{
+			const auto found = ensure_section(section);
+			auto &declared = found->second.parent;
+			if (!declared.empty())
+			{
+				remove(found, detail::parent_fingerprint(found->second.seeds, declared));
+				forget_child(declared, *found);
+			}
+			if (!parent.empty())
+			{
+				add(found, detail::parent_fingerprint(found->second.seeds, parent));
+				m_children.emplace(parent, &*found);
+			}
+			m_parented += static_cast<std::size_t>(!parent.empty()) -
+						  static_cast<std::size_t>(!declared.empty());
+			declared = std::move(parent);
+			resolve_ancestors(*found);
+		}
+
+		/**
+		 * @brief Checks whether any section declares a parent.
+		 */
+		auto has_parents() const noexcept -> bool
+		{
+			return m_parented != 0;
+		}
+
+		/**
+		 * @brief Finds a value in a section or, failing that, along its ancestors.
+		 */
+		auto lookup(std::string_view section, std::string_view key) const
+			-> std::optional<std::string_view>
+		{
+			const auto may_hold = [this, key](std::string_view name) {
+				return !m_filter || m_filter->may_contain(detail::hash_entry(name, key));
+			};
+			const bool held = may_hold(section);
+			// Without parents a key the filter rules out cannot be found anywhere
+			if (!held && m_parented == 0)
+			{
+				return std::nullopt;
+			}
+			const auto found = m_sections.find(section);
+			if (found == m_sections.end())
+			{
+				return std::nullopt;
+			}
+			if (const auto entry = held ? found->second.find(key) : found->second.end();
+				entry != found->second.end())
+			{
+				return std::string_view{entry->second};
+			}
+			if (found->second.parent.empty())
+			{
+				return std::nullopt;
+			}
+			for (const auto *ancestor : found->second.ancestors)
+			{
+				if (!may_hold(ancestor->first))
+				{
+					continue;
+				}
+				if (const auto entry = ancestor->second.find(key);
+					entry != ancestor->second.end())
+				{
+					return std::string_view{entry->second};
+				}
+			}
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Gets the existing ancestors of a section, nearest first.
+		 */
+		static auto ancestors(const data_map::value_type &section) noexcept
+			-> const ancestor_list &
+		{
+			return section.second.ancestors;
+		}
+
+		/**
+		 * @brief Finds an entry, creating it with an empty value if it does not exist.
+		 */
+		auto ensure_entry(data_map::iterator section, std::string_view key)
+			-> entry_map::iterator
+		{
+			auto &entries = section->second;
+			auto found = entries.lower_bound(key);
+			if (found != entries.end() && found->first == key)
+			{
+				return found;
+			}
+			found = entries.emplace_hint(found, std::string{key}, std::string{});
+			track(section, *found);
+			admit(section, found->first);
+			return found;
+		}
+
+		/**
+		 * @brief Replaces the value of an existing entry.
+		 */
+		void assign(data_map::iterator section, entry_map::iterator entry,
+					std::string value)
+		{
+			untrack(section, *entry);
+			entry->second = std::move(value);
+			track(section, *entry);
+		}
+
+		/**
+		 * @brief Sets a value, creating its section and key as needed.
+		 */
+		void assign(data_map::iterator section, std::string_view key, std::string value)
+		{
+			auto &entries = section->second;
+			auto found = entries.lower_bound(key);
+			if (found != entries.end() && found->first == key)
+			{
+				assign(section, found, std::move(value));
+				return;
+			}
+			found = entries.emplace_hint(found, std::string{key}, std::move(value));
+			track(section, *found);
+			admit(section, found->first);
+		}
+
+		/**
+		 * @brief Sets a value, creating its section and key as needed.
+		 */
+		void assign(std::string_view section, std::string_view key, std::string value)
+		{
+			assign(ensure_section(section), key, std::move(value));
+		}
+
+		/**
+		 * @brief Removes an entry.
+		 * @return `true` if the entry existed.
+		 */
+		auto erase(data_map::iterator section, std::string_view key) -> bool
+		{
+			auto &entries = section->second;
+			const auto found = entries.find(key);
+			if (found == entries.end())
+			{
+				return false;
+			}
+			untrack(section, *found);
+			entries.erase(found);
+			dismiss(section, 1);
+			return true;
+		}
+
+		/**
+		 * @brief Removes an entry.
+		 * @return `true` if the entry existed.
+		 */
+		auto erase(std::string_view section, std::string_view key) -> bool
+		{
+			const auto found = m_sections.find(section);
+			return found != m_sections.end() && erase(found, key);
+		}
+
+		/**
+		 * @brief Removes a section with all its entries.
+		 * @return `true` if the section existed.
+		 */
+		auto erase_section(std::string_view section) -> bool
+		{
+			const auto found = m_sections.find(section);
+			if (found == m_sections.end())
+			{
+				return false;
+			}
+			m_fingerprint -= found->second.fingerprint;
+			m_bytes -= section.size();
+			shrunk(*found);
+			if (m_tree)
+			{
+				unlink(section);
+			}
+			if (!found->second.parent.empty())
+			{
+				--m_parented;
+				forget_child(found->second.parent, *found);
+			}
+			// The chains through the section end at it once it is gone
+			std::vector<data_map::value_type *> orphans;
+			for (auto [child, last] = m_children.equal_range(section); child != last;
+				 ++child)
+			{
+				orphans.push_back(child->second);
+			}
+			for (const auto &entry : found->second)
+			{
+				m_bytes -= entry.first.size() + entry.second.size();
+				if (m_values)
+				{
+					unindex(entry);
+				}
+				if (m_interpolations)
+				{
+					const auto id = detail::hash_entry(section, entry.first);
+					m_interpolations->invalidate(id);
+				}
+			}
+			const auto keys = found->second.size();
+			m_sections.erase(found);
+			m_keys -= keys;
+			forget_keys(keys);
+			for (auto *orphan : orphans)
+			{
+				resolve_ancestors(*orphan);
+			}
+			return true;
+		}
+
+	  private:
+		data_map m_sections;
+		ini::fingerprint128 m_fingerprint;
+		std::size_t m_keys = 0;
+		std::size_t m_bytes = 0;
+		// The section holding the most keys. Once it loses keys, any other section may
+		// have become the largest, so it is looked for again on the next stats() call.
+		mutable std::atomic<const data_map::value_type *> m_largest = nullptr;
+		mutable std::atomic<bool> m_largest_stale = false;
+		std::unique_ptr<tree_node> m_tree;
+		std::unique_ptr<value_index> m_values;
+		std::unique_ptr<detail::key_filter> m_filter;
+		// The sections declaring a parent, whose lookups go on to their ancestors when
+		// the key filter rules out their own entries
+		std::size_t m_parented = 0;
+		std::unique_ptr<detail::interpolation_cache> m_interpolations;
+		std::once_flag m_interpolations_created;
+		// The sections declaring each parent, existing or not
+		std::multimap<std::string, data_map::value_type *, std::less<>> m_children;
+
+		/**
+		 * @brief Resolves the ancestors of a section and of every section below it,
+		 * after the chain of the section may have changed.
+		 */
+		void resolve_ancestors(data_map::value_type &section)
+		{
+			std::vector<data_map::value_type *> pending{&section};
+			// Stop at a cycle rather than looping, should one ever be declared
+			std::set<const data_map::value_type *> resolved;
+			while (!pending.empty())
+			{
+				auto &current = *pending.back();
+				pending.pop_back();
+				if (!resolved.insert(&current).second)
+				{
+					continue;
+				}
+				auto &ancestors = current.second.ancestors;
+				ancestors.clear();
+				const auto parent = current.second.parent.empty()
+										? m_sections.end()
+										: m_sections.find(current.second.parent);
+				if (parent != m_sections.end() && &*parent != &current)
+				{
+					ancestors.push_back(&*parent);
+					for (const auto *ancestor : parent->second.ancestors)
+					{
+						if (ancestor == &current)
+						{
+							break;
+						}
+						ancestors.push_back(ancestor);
+					}
+				}
+				for (auto [child, last] = m_children.equal_range(current.first);
+					 child != last; ++child)
+				{
+					pending.push_back(child->second);
+				}
+			}
+		}
+
+		/**
+		 * @brief Drops a section from the sections declaring a parent.
+		 */
+		void forget_child(std::string_view parent, const data_map::value_type &section)
+		{
+			for (auto [child, last] = m_children.equal_range(parent); child != last;
+				 ++child)
+			{
+				if (child->second == &section)
+				{
+					m_children.erase(child);
+					return;
+				}
+			}
+		}
+
+		/**
+		 * @brief Refills the key filter from the current entries, sized for twice as
+		 * many keys so that it does not grow again soon.
+		 */
+		void rebuild_filter()
+		{
+			std::size_t keys = 0;
+			for (const auto &section : m_sections)
+			{
+				keys += section.second.size();
+			}
+			m_filter->reset(keys * 2);
+			for (const auto &section : m_sections)
+			{
+				for (const auto &entry : section.second)
+				{
+					m_filter->insert(detail::hash_entry(section.first, entry.first));
+				}
+			}
+			m_filter->keys = keys;
+		}
+
+		/**
+		 * @brief Counts a new key of a section and adds it to the key filter, growing
+		 * the filter as needed.
+		 */
+		void admit(data_map::iterator section, std::string_view key)
+		{
+			++m_keys;
+			grown(*section);
+			if (!m_filter)
+			{
+				return;
+			}
+			++m_filter->keys;
+			if (m_filter->needs_rebuild())
+			{
+				rebuild_filter();
+				return;
+			}
+			m_filter->insert(detail::hash_entry(section->first, key));
+		}
+
+		/**
+		 * @brief Uncounts a key removed from a section.
+		 */
+		void dismiss(data_map::iterator section, std::size_t keys)
+		{
+			m_keys -= keys;
+			shrunk(*section);
+			forget_keys(keys);
+		}
+
+		/**
+		 * @brief Notes a section that was added or gained a key, which may now be the
+		 * largest one.
+		 */
+		void grown(const data_map::value_type &section) noexcept
+		{
+			if (m_largest_stale.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+			const auto *largest = m_largest.load(std::memory_order_relaxed);
+			if (largest == nullptr || section.second.size() > largest->second.size() ||
+				(section.second.size() == largest->second.size() &&
+				 section.first < largest->first))
+			{
+				m_largest.store(&section, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @brief Notes a section that lost keys or is about to be removed.
+		 */
+		void shrunk(const data_map::value_type &section) noexcept
+		{
+			if (m_largest.load(std::memory_order_relaxed) == &section)
+			{
+				m_largest.store(nullptr, std::memory_order_relaxed);
+				m_largest_stale.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @brief Records removed keys in the key filter, rebuilding it once more of
+		 * its bits belong to removed keys than to present ones.
+		 */
+		void forget_keys(std::size_t keys)
+		{
+			if (!m_filter)
+			{
+				return;
+			}
+			m_filter->keys -= keys;
+			m_filter->stale += keys;
+			if (m_filter->needs_rebuild())
+			{
+				rebuild_filter();
+			}
+		}
+
+		/**
+		 * @brief Adds a section to the tree, creating the nodes leading to it.
+		 */
+		void link(const data_map::value_type &section)
+		{
+			auto *node = m_tree.get();
+			for (const auto component : detail::dotted_components(section.first))
+			{
+				node = &node->children.try_emplace(std::string{component}).first->second;
+			}
+			node->section = &section;
+		}
+
+		/**
+		 * @brief Removes a section from the tree, pruning the nodes that no longer
+		 * lead to any section.
+		 */
+		void unlink(std::string_view section)
+		{
+			// The nodes on the path, each with the component leading to it
+			std::vector<std::pair<tree_node *, std::string_view>> path{
+				{m_tree.get(), {}}};
+			for (const auto component : detail::dotted_components(section))
+			{
+				auto &children = path.back().first->children;
+				path.emplace_back(&children.find(component)->second, component);
+			}
+			path.back().first->section = nullptr;
+			for (auto depth = path.size() - 1; depth > 0; --depth)
+			{
+				const auto &[node, component] = path[depth];
+				if (node->section != nullptr || !node->children.empty())
+				{
+					break;
+				}
+				auto &siblings = path[depth - 1].first->children;
+				siblings.erase(siblings.find(component));
+			}
+		}
+
+		/**
+		 * @brief Adds a new or changed entry to the summaries and indexes.
+		 */
+		void track(data_map::iterator section, const entry_map::value_type &entry)
+		{
+			m_bytes += entry.first.size() + entry.second.size();
+			const auto &seeds = section->second.seeds;
+			add(section, detail::entry_fingerprint(seeds, entry.first, entry.second));
+			if (m_values)
+			{
+				index(section->first, entry);
+			}
+		}
+
+		/**
+		 * @brief Removes an entry about to change or disappear from the summaries and
+		 * indexes.
+		 */
+		void untrack(data_map::iterator section, const entry_map::value_type &entry)
+		{
+			m_bytes -= entry.first.size() + entry.second.size();
+			const auto &seeds = section->second.seeds;
+			remove(section, detail::entry_fingerprint(seeds, entry.first, entry.second));
+			if (m_values)
+			{
+				unindex(entry);
+			}
+			if (m_interpolations)
+			{
+				const auto id = detail::hash_entry(section->first, entry.first);
+				m_interpolations->invalidate(id);
+			}
+		}
+
+		void index(const std::string &section, const entry_map::value_type &entry)
+		{
+			auto found = m_values->find(entry.second);
+			if (found == m_values->end())
+			{
+				found = m_values->try_emplace(entry.second).first;
+			}
+			found->second.push_back({&section, &entry.first});
+		}
+
+		void unindex(const entry_map::value_type &entry)
+		{
+			const auto found = m_values->find(entry.second);
+			std::erase_if(found->second, [&entry](const value_location &location) {
+				return location.key == &entry.first;
+			});
+			if (found->second.empty())
+			{
+				m_values->erase(found);
+			}
+		}
+
+		void add(data_map::iterator section, const ini::fingerprint128 &contribution)
+		{
+			section->second.fingerprint += contribution;
+			m_fingerprint += contribution;
+		}
+
+		void remove(data_map::iterator section, const ini::fingerprint128 &contribution)
+		{
+			section->second.fingerprint -= contribution;
+			m_fingerprint -= contribution;
+		}
+	};
+
+  public:
+	/**
+	 * @brief Default constructor for the ini_manager class.
+	 *
+	 * Initializes an empty INI configuration.
+	 */
+	ini_manager() : m_data(std::make_shared<storage>())
+	{
+	}
+
+	/**
+	 * @brief Creates an ini_manager object by loading data from a file.
+	 * @param file_path The path to the INI file.
+	 * @param options Options controlling how the file is loaded.
+	 * @return A `std::expected` containing the ini_manager object on success,
+	 * or a `std::error_code` on failure.
+	 */
+	static auto from_file(const std::string &file_path, const load_options &options = {})
+		-> std::expected<ini_manager, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::loads,
+										 detail::counter::load_nanoseconds};
+		detail::trace_scope trace{trace_event::load, file_path};
+		ini_manager manager;
+		auto result = trace.complete(manager.load(file_path, options));
+		if (result.has_value())
+		{
+			manager.m_file_path = file_path;
+			return manager;
+		}
+		return std::unexpected(result.error());
+	}
+
+	/**
+	 * @brief Creates an ini_manager object by parsing data from an input stream.
+	 * @param istream The input stream containing INI data.
+	 * @param options Options controlling how include directives are handled.
+	 * @return A `std::expected` containing the ini_manager object on success,
+	 * or a `std::error_code` on failure.
+	 */
+	static auto from_stream(std::istream &istream, const load_options &options = {})
+		-> std::expected<ini_manager, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::loads,
+										 detail::counter::load_nanoseconds};
+		detail::trace_scope trace{trace_event::load};
+		ini_manager manager;
+		parse_context context{options};
+		auto result = trace.complete(manager.parse(istream, context));
+		if (result.has_value())
+		{
+			return manager;
+		}
+		return std::unexpected(result.error());
+	}
+
+	/**
+	 * @brief Refers to the value of one key for reading and assignment.
+	 *
+	 * Assignments go through the manager, so fingerprints and other summaries stay up
+	 * to date. Like a reference, it must not outlive the removal of its key or section.
+	 * It supports assignment of strings and formattable values, `append` and `+=`, and
+	 * converts to `const std::string &`. Code that needs a mutable `std::string &`,
+	 * such as `std::getline`, reads into a string first and assigns it.
+	 */
+	class value_reference
+	{
+	  public:
+		/**
+		 * @brief Constructs a value_reference.
+		 * @param data A shared pointer to the underlying data.
+		 * @param section The section holding the key.
+		 * @param entry The key and its value.
+		 */
+		value_reference(std::shared_ptr<storage> data, data_map::iterator section,
+						entry_map::iterator entry)
+			: m_data(std::move(data)), m_section(section), m_entry(entry)
+		{
+		}
+
+		value_reference(const value_reference &) = default;
+		value_reference(value_reference &&) noexcept = default;
+		~value_reference() = default;
+
+		/**
+		 * @brief Assigns a new value.
+		 * @param value The value to assign.
+		 * @return A reference to this object.
+		 */
+		auto operator=(std::string_view value) -> value_reference &
+		{
+			m_data->assign(m_section, m_entry, std::string{value});
+			return *this;
+		}
+
+		/**
+		 * @brief Assigns the value another reference refers to.
+		 * @param other The reference whose value to assign.
+		 * @return A reference to this object.
+		 */
+		auto operator=(const value_reference &other) -> value_reference &
+		{
+			return *this = std::string_view{other.value()};
+		}
+
+		auto operator=(value_reference &&other) -> value_reference &
+		{
+			return *this = std::string_view{other.value()};
+		}
+
+		/**
+		 * @brief Assigns a value formatted with `std::format`, as `set_value` does,
+		 * e.g. a number.
+		 * @param value The value to assign.
+		 * @return A reference to this object.
+		 */
+		template <typename T>
+			requires(!std::convertible_to<const T &, std::string_view> &&
+					 !std::same_as<T, value_reference> && std::formattable<T, char>)
+		auto operator=(const T &value) -> value_reference &
+		{
+			m_data->assign(m_section, m_entry, std::format("{}", value));
+			return *this;
+		}
+
+		/**
+		 * @brief Appends text to the value.
+		 * @param text The text to append.
+		 * @return A reference to this object.
+		 */
+		auto append(std::string_view text) -> value_reference &
+		{
+			auto appended = value();
+			appended.append(text);
+			m_data->assign(m_section, m_entry, std::move(appended));
+			return *this;
+		}
+
+		auto operator+=(std::string_view text) -> value_reference &
+		{
+			return append(text);
+		}
+
+		auto operator+=(char character) -> value_reference &
+		{
+			return append(std::string_view{&character, 1});
+		}
+
+		/**
+		 * @brief Gets the value.
+		 * @return The value.
+		 */
+		auto value() const noexcept -> const std::string &
+		{
+			return m_entry->second;
+		}
+
+		/**
+		 * @brief Converts to the value.
+		 */
+		operator const std::string &() const noexcept
+		{
+			return value();
+		}
+
+		/**
+		 * @brief Checks whether the value is empty.
+		 * @return `true` if the value is empty.
+		 */
+		auto empty() const noexcept -> bool
+		{
+			return value().empty();
+		}
+
+		/**
+		 * @brief Compares the value with a string.
+		 */
+		friend auto operator==(const value_reference &reference,
+							   std::string_view text) noexcept -> bool
+		{
+			return reference.value() == text;
+		}
+
+	  private:
+		std::shared_ptr<storage> m_data;
+		data_map::iterator m_section;
+		entry_map::iterator m_entry;
+	};
+
+	/**
+	 * @brief Provides non-const access to keys within a specific section.
+	 */
+	class section_accessor
+	{
+	  public:
+		/**
+		 * @brief Constructs a section_accessor.
+		 * @param data A shared pointer to the underlying data.
+		 * @param section_name The name of the section.
+		 */
+		explicit section_accessor(std::shared_ptr<storage> data,
+								  std::string section_name)
+			: m_data(std::move(data)), m_section_name(std::move(section_name))
+		{
+		}
+
+		/**
+		 * @brief Accesses a key within the section for modification.
+		 * If the section or key does not exist, it will be created.
+		 * @param key The name of the key.
+		 * @return A reference to the value associated with the key.
+		 */
+		auto operator[](std::string_view key) -> value_reference
+		{
+			const auto section = m_data->ensure_section(m_section_name);
+			return value_reference{m_data, section, m_data->ensure_entry(section, key)};
+		}
+
+	  private:
+		std::shared_ptr<storage> m_data;
+		std::string m_section_name;
+	};
+
+	/**
+	 * @brief Provides const access to keys within a specific section.
+	 */
+	class const_section_accessor
+	{
+	  public:
+		/**
+		 * @brief Constructs a const_section_accessor.
+		 * @param data A shared pointer to the underlying data (const).
+		 * @param section_name The name of the section.
+		 */
+		explicit const_section_accessor(std::shared_ptr<const storage> data,
+										std::string section_name)
+			: m_data(std::move(data)), m_section_name(std::move(section_name))
+		{
+		}
+
+		/**
+		 * @brief Accesses a key within the section for reading.
+		 * @param key The name of the key.
+		 * @return A `std::optional` containing the string value associated with the key,
+		 * or `std::nullopt` if the key or section does not exist.
+		 */
+		auto operator[](std::string_view key) const -> std::optional<std::string>
+		{
+			const auto value = m_data->lookup(m_section_name, key);
+			detail::count_lookup(lookup_api::subscript, value.has_value());
+			if (value.has_value())
+			{
+				return std::string{*value};
+			}
+			return std::nullopt;
+		}
+
+	  private:
+		std::shared_ptr<const storage> m_data;
+		std::string m_section_name;
+	};
+
+	/**
+	 * @brief Provides non-const access to a specific section.
+	 * @param section The name of the section.
+	 * @return A `section_accessor` object for accessing keys within the section.
+	 */
+	auto operator[](std::string_view section) -> section_accessor
+	{
+		return section_accessor{m_data, std::string{section}};
+	}
+
+	/**
+	 * @brief Provides const access to a specific section.
+	 * @param section The name of the section.
+	 * @return A `const_section_accessor` object for accessing keys within the section.
+	 */
+	auto operator[](std::string_view section) const -> const_section_accessor
+	{
+		return const_section_accessor{m_data, std::string{section}};
+	}
+
+	/**
+	 * @brief Retrieves a string value for a given section and key.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing the string value,
+	 * or `std::nullopt` if the section or key does not exist.
+	 */
+	auto get_value(section section, key key) const noexcept -> std::optional<std::string>
+	{
+		const auto value = m_data->lookup(section.value, key.value);
+		detail::count_lookup(lookup_api::get_value, value.has_value());
+		if (value.has_value())
+		{
+			return std::string{*value};
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Retrieves a value of a specific type for a given section and key.
+	 * @tparam T The type of the value to retrieve. Must be `std::string`, `bool`,
+	 * or satisfy the `StreamExtractable` concept.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing the value of type `T`,
+	 * or `std::nullopt` if the section or key does not exist, or if the
+	 * value cannot be converted to the requested type.
+	 * @concept StreamExtractable<T>
+	 */
+	template <typename T>
+	auto get_value(section section, key key) const noexcept -> std::optional<T>
+	{
+		const auto value = m_data->lookup(section.value, key.value);
+		detail::count_lookup(lookup_api::get_value_as, value.has_value());
+		if (value.has_value())
+		{
+			return detail::convert_value<T>(*value);
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Retrieves a string value for a given section and key, or a default value if
+	 * not found.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @param default_value The value to return if the section or key does not exist.
+	 * @return The string value associated with the key, or the default value.
+	 */
+	auto get_value_or_default(section section, key key,
+							  std::string default_value) const noexcept -> std::string
+	{
+		return get_value(section, key).value_or(std::move(default_value));
+	}
+
+	/**
+	 * @brief Retrieves a value of a specific type for a given section and key,
+	 * or a default value if not found.
+	 * @tparam T The type of the value to retrieve. Must be `std::string`, `bool`,
+	 * or satisfy the `StreamExtractable` concept.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @param default_value The value to return if the section or key does not exist,
+	 * or if the value cannot be converted to the requested type.
+	 * @return The value of type `T` associated with the key, or the default value.
+	 * @concept StreamExtractable<T>
+	 */
+	template <typename T>
+	auto get_value_or_default(section section, key key, T default_value) const noexcept
+		-> T
+	{
+		return get_value<T>(section, key).value_or(std::move(default_value));
+	}
+
+	/**
+	 * @brief Sets a value for a given section and key.
+	 * @tparam T The type of the value to set. Must be formattable using `std::format`.
+	 * @param section The name of the section.
+	 * @param key The name of the key.
+	 * @param value The value to set.
+	 * @requires std::formattable<T, char>
+	 */
+	template <typename T>
+		requires std::formattable<T, char>
+	void set_value(std::string_view section, std::string_view key, T value) noexcept
+	{
+		m_data->assign(section, key, std::format("{}", value));
+	}
+
+	/**
+	 * @brief Sets a section in the INI data. If the section does not exist, it is
+	 * created.
+	 * @param section The name of the section to set.
+	 */
+	void set_section(const std::string &section) noexcept
+	{
+		// Creates a new empty section only if it doesn't exist
+		m_data->ensure_section(section);
+	}
+
+	/**
+	 * @brief Removes a key-value pair from a section.
+	 * @param section The section containing the key to remove.
+	 * @param key The key to remove.
+	 * @return `true` if the key was successfully removed, `false` otherwise.
+	 */
+	auto remove_value(section section, key key) noexcept -> bool
+	{
+		return m_data->erase(section.value, key.value);
+	}
+
+	/**
+	 * @brief Removes an entire section from the INI data.
+	 * @param section The section to remove.
+	 * @return `true` if the section was successfully removed, `false` otherwise.
+	 */
+	auto remove_section(section section) noexcept -> bool
+	{
+		return m_data->erase_section(section.value);
+	}
+
+	/**
+	 * @brief Gets a list of all section names in the INI data.
+	 * @return A `std::vector` containing the names of all sections.
+	 * The order corresponds to the map's internal ordering (typically
+	 * alphabetical).
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		auto key_view = std::views::keys(m_data->sections());
+		return {key_view.begin(), key_view.end()};
+	}
+
+	/**
+	 * @brief Gets a list of all key names within a specific section.
+	 * @param section The section whose keys are to be retrieved.
+	 * @return A `std::vector` containing the names of all keys in the specified section.
+	 * Returns an empty vector if the section does not exist.
+	 * The order corresponds to the map's internal ordering (typically
+	 * alphabetical).
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		const auto section_it = m_data->find(section.value);
+		if (section_it != m_data->sections().end())
+		{
+			auto key_view = std::views::keys(section_it->second);
+			return {key_view.begin(), key_view.end()};
+		}
+		// Section not found, return an empty vector
+		return {};
+	}
+
+	/**
+	 * @brief Lists all sections without copying their names.
+	 *
+	 * Unlike `get_sections`, this allocates nothing: the result is a lazy view of
+	 * `std::string_view`s over the stored names, in alphabetical order. It stays valid
+	 * until a listed section is removed or `load_file` or `load_stream` replaces the
+	 * data.
+	 * @return The view.
+	 */
+	auto sections() const
+	{
+		const auto &sections = m_data->sections();
+		return detail::names(sections.begin(), sections.end());
+	}
+
+	/**
+	 * @brief Lists the keys and values of a section without copying them.
+	 *
+	 * Unlike `get_keys`, this allocates nothing: the result is a lazy view of
+	 * `std::pair<std::string_view, std::string_view>` over the stored entries, in
+	 * alphabetical order of the keys. It stays valid until the section is removed or
+	 * `load_file` or `load_stream` replaces the data; a listed value changes when it
+	 * is assigned.
+	 * @param section The section whose entries are listed.
+	 * @return The view, empty if the section does not exist.
+	 */
+	auto entries(section section) const
+	{
+		const auto found = m_data->find(section.value);
+		const bool exists = found != m_data->sections().end();
+		const entry_map::const_iterator none{};
+		return std::ranges::subrange(exists ? found->second.begin() : none,
+									 exists ? found->second.end() : none) |
+			   std::views::transform([](const entry_map::value_type &entry) {
+				   return std::pair<std::string_view, std::string_view>{entry.first,
+																		entry.second};
+			   });
+	}
+
+	/**
+	 * @brief Calls a function for every entry, without allocating.
+	 *
+	 * Sections are visited in alphabetical order and the entries of each section in
+	 * alphabetical order of the keys. Sections without entries are not visited. The
+	 * function must not add or remove sections or keys.
+	 * @param function Called with the section, key and value as `std::string_view`s.
+	 */
+	template <typename Function>
+		requires std::invocable<Function &, std::string_view, std::string_view,
+								std::string_view>
+	void for_each(Function &&function) const
+	{
+		for (const auto &[section, entries] : m_data->sections())
+		{
+			for (const auto &[key, value] : entries)
+			{
+				function(std::string_view{section}, std::string_view{key},
+						 std::string_view{value});
+			}
+		}
+	}
+
+	/**
+	 * @brief Retrieves a value without copying it.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing a view of the stored value, valid until the
+	 * value is assigned or removed or `load_file` or `load_stream` replaces the data,
+	 * or `std::nullopt` if the section or key does not exist. Keys the section does
+	 * not hold are looked up along its declared parents, see `set_parent`.
+	 */
+	auto get_value_view(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		const auto value = m_data->lookup(section.value, key.value);
+		detail::count_lookup(lookup_api::get_value_view, value.has_value());
+		return value;
+	}
+
+	/**
+	 * @brief Lists the keys of a section that start with a prefix, e.g. `db.primary.`.
+	 *
+	 * The result is a lazy view of `std::string_view`s over the stored keys, in
+	 * alphabetical order: finding the first key takes O(log n) and each further one
+	 * O(1), and no key is copied. It stays valid until the section is removed or
+	 * `load_file` or `load_stream` replaces the data.
+	 * @param section The section whose keys are listed.
+	 * @param prefix The prefix; an empty prefix lists every key.
+	 * @return The view, empty if the section does not exist.
+	 */
+	auto keys_with_prefix(section section, std::string_view prefix) const
+	{
+		const auto found = m_data->find(section.value);
+		if (found == m_data->sections().end())
+		{
+			const entry_map::const_iterator none{};
+			return detail::names(none, none);
+		}
+		const entry_map &entries = found->second;
+		return detail::names(entries.lower_bound(prefix),
+							 entries.upper_bound(detail::prefix_bound{prefix}));
+	}
+
+	/**
+	 * @brief Lists the keys of a section from `first` up to but excluding `last`, as a
+	 * lazy view like `keys_with_prefix`.
+	 * @param section The section whose keys are listed.
+	 * @param first The lower bound of the keys, inclusive.
+	 * @param last The upper bound of the keys, exclusive.
+	 * @return The view, empty if the section does not exist or `last` is not greater
+	 * than `first`.
+	 */
+	auto keys_in_range(section section, std::string_view first,
+					   std::string_view last) const
+	{
+		const auto found = m_data->find(section.value);
+		if (found == m_data->sections().end() || last <= first)
+		{
+			const entry_map::const_iterator none{};
+			return detail::names(none, none);
+		}
+		const entry_map &entries = found->second;
+		return detail::names(entries.lower_bound(first), entries.lower_bound(last));
+	}
+
+	/**
+	 * @brief Lists the sections that start with a prefix, as a lazy view like
+	 * `keys_with_prefix`. It stays valid until a listed section is removed or
+	 * `load_file` or `load_stream` replaces the data.
+	 * @param prefix The prefix; an empty prefix lists every section.
+	 * @return The view.
+	 */
+	auto sections_with_prefix(std::string_view prefix) const
+	{
+		const auto &sections = m_data->sections();
+		return detail::names(sections.lower_bound(prefix),
+							 sections.upper_bound(detail::prefix_bound{prefix}));
+	}
+
+	/**
+	 * @brief Lists the sections from `first` up to but excluding `last`, as a lazy
+	 * view like `sections_with_prefix`.
+	 * @param first The lower bound of the sections, inclusive.
+	 * @param last The upper bound of the sections, exclusive.
+	 * @return The view, empty if `last` is not greater than `first`.
+	 */
+	auto sections_in_range(std::string_view first, std::string_view last) const
+	{
+		const auto &sections = m_data->sections();
+		if (last <= first)
+		{
+			return detail::names(sections.end(), sections.end());
+		}
+		return detail::names(sections.lower_bound(first), sections.lower_bound(last));
+	}
+
+	/**
+	 * @brief Lists the sections matching a glob pattern, e.g. `tenant-*`.
+	 *
+	 * Only the sections starting with the pattern's literal prefix are visited, found
+	 * in O(log n); each of them is matched with the compiled pattern. The result is a
+	 * lazy view of `std::string_view`s in alphabetical order, valid like
+	 * `sections_with_prefix`.
+	 * @param pattern The compiled pattern, kept by the view.
+	 * @return The view.
+	 */
+	auto sections_matching(glob pattern) const
+	{
+		const auto &sections = m_data->sections();
+		const auto prefix = pattern.literal_prefix();
+		// The prefix views the pattern, so find the bounds before moving it
+		const auto first = sections.lower_bound(prefix);
+		const auto last = sections.upper_bound(detail::prefix_bound{prefix});
+		return detail::names(first, last) |
+			   std::views::filter(detail::glob_filter{std::move(pattern)});
+	}
+
+	/**
+	 * @brief Lists the keys of a section matching a glob pattern, e.g. `*.timeout_ms`,
+	 * pruned by its literal prefix like `sections_matching`.
+	 * @param section The section whose keys are listed.
+	 * @param pattern The compiled pattern, kept by the view.
+	 * @return The view, empty if the section does not exist.
+	 */
+	auto keys_matching(section section, glob pattern) const
+	{
+		const auto prefix = pattern.literal_prefix();
+		const auto found = m_data->find(section.value);
+		entry_map::const_iterator first{};
+		entry_map::const_iterator last{};
+		if (found != m_data->sections().end())
+		{
+			first = found->second.lower_bound(prefix);
+			last = found->second.upper_bound(detail::prefix_bound{prefix});
+		}
+		return detail::names(first, last) |
+			   std::views::filter(detail::glob_filter{std::move(pattern)});
+	}
+
+	/**
+	 * @brief Calls a function for every entry whose section and key match two glob
+	 * patterns, e.g. every `*.timeout_ms` key of every `tenant-*` section. Sections
+	 * and keys are pruned by the patterns' literal prefixes.
+	 * @param sections The pattern for section names.
+	 * @param keys The pattern for key names.
+	 * @param function Called with the section, key and value as `std::string_view`s,
+	 * in order.
+	 */
+	template <typename Function>
+		requires std::invocable<Function &, std::string_view, std::string_view,
+								std::string_view>
+	void for_each_match(const glob &sections, const glob &keys, Function &&function) const
+	{
+		const auto &data = m_data->sections();
+		const auto section_prefix = sections.literal_prefix();
+		const auto key_prefix = keys.literal_prefix();
+		const auto last_section = data.upper_bound(detail::prefix_bound{section_prefix});
+		for (auto section = data.lower_bound(section_prefix); section != last_section;
+			 ++section)
+		{
+			if (!sections.matches(section->first))
+			{
+				continue;
+			}
+			const entry_map &entries = section->second;
+			const auto last_key = entries.upper_bound(detail::prefix_bound{key_prefix});
+			for (auto entry = entries.lower_bound(key_prefix); entry != last_key; ++entry)
+			{
+				if (keys.matches(entry->first))
+				{
+					function(std::string_view{section->first},
+							 std::string_view{entry->first},
+							 std::string_view{entry->second});
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Starts maintaining the dotted section tree index.
+	 *
+	 * Section names such as `[service.cache.l1]` are read as paths in a tree, kept up
+	 * to date as sections are added and removed. `subsections` and
+	 * `nearest_section_with_key` then walk the tree instead of splitting names and
+	 * searching the section map level by level; they give the same results either way.
+	 * The index can also be requested with `load_options::section_tree`.
+	 */
+	void enable_section_tree()
+	{
+		m_data->enable_tree();
+	}
+
+	/**
+	 * @brief Checks whether the dotted section tree index is maintained.
+	 * @return `true` if it is.
+	 */
+	auto has_section_tree() const noexcept -> bool
+	{
+		return m_data->tree() != nullptr;
+	}
+
+	/**
+	 * @brief Lists the dotted subsections of a section at any depth, e.g.
+	 * `service.cache` and `service.cache.l1` for `service`.
+	 * @param section The section; it need not exist itself.
+	 * @return The names of the existing subsections, each before its own subsections
+	 * and siblings in alphabetical order. They stay valid until the section they name
+	 * is removed or `load_file` or `load_stream` replaces the data.
+	 */
+	auto subsections(section section) const -> std::vector<std::string_view>
+	{
+		std::vector<std::string_view> names;
+		if (const auto *root = m_data->tree())
+		{
+			const auto *node = root;
+			for (const auto component : detail::dotted_components(section.value))
+			{
+				const auto child = node->children.find(component);
+				if (child == node->children.end())
+				{
+					return names;
+				}
+				node = &child->second;
+			}
+			collect_subsections(*node, names);
+			return names;
+		}
+
+		const auto prefix = std::string{section.value} + '.';
+		for (const auto name : sections_with_prefix(prefix))
+		{
+			names.push_back(name);
+		}
+		std::ranges::sort(names, detail::tree_order);
+		return names;
+	}
+
+	/**
+	 * @brief Finds the nearest section holding a key among a section and its dotted
+	 * ancestors, e.g. `service.cache.l1`, then `service.cache`, then `service`.
+	 * @param section The section to start from; it need not exist itself.
+	 * @param key The key to look for.
+	 * @return The name of the nearest section holding the key, or `std::nullopt` if
+	 * none does.
+	 */
+	auto nearest_section_with_key(section section, key key) const
+		-> std::optional<std::string_view>
+	{
+		if (const auto *root = m_data->tree())
+		{
+			std::optional<std::string_view> nearest;
+			const auto *node = root;
+			const auto visit = [&nearest, &key](const storage::tree_node &visited) {
+				if (visited.section != nullptr &&
+					visited.section->second.contains(key.value))
+				{
+					nearest = visited.section->first;
+				}
+			};
+			visit(*node);
+			for (const auto component : detail::dotted_components(section.value))
+			{
+				const auto child = node->children.find(component);
+				if (child == node->children.end())
+				{
+					break;
+				}
+				node = &child->second;
+				visit(*node);
+			}
+			return nearest;
+		}
+
+		for (auto name = section.value;;)
+		{
+			if (const auto found = m_data->find(name);
+				found != m_data->sections().end() && found->second.contains(key.value))
+			{
+				return std::string_view{found->first};
+			}
+			const auto dot = name.rfind('.');
+			if (dot == std::string_view::npos)
+			{
+				return std::nullopt;
+			}
+			name = name.substr(0, dot);
+		}
+	}
+
+	/**
+	 * @brief Retrieves a value from a section or, failing that, from its nearest dotted
+	 * ancestor holding the key; see `nearest_section_with_key`.
+	 * @param section The section to start from.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing the value, or `std::nullopt` if neither the
+	 * section nor any ancestor holds the key.
+	 */
+	auto get_inherited_value(section section, key key) const -> std::optional<std::string>
+	{
+		if (const auto nearest = nearest_section_with_key(section, key))
+		{
+			return get_value(ini::section{*nearest}, key);
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Declares the parent of a section, as `[section : parent]` does when
+	 * loading with `load_options::inheritance`.
+	 *
+	 * Lookups of keys the section does not hold fall through to its parent, then to
+	 * the parent's parent and so on. Chains are resolved whenever a section is added,
+	 * removed or re-parented, so lookups neither lock nor allocate. The section is
+	 * created if it does not exist; the parent need not exist yet. Writing emits the
+	 * declaration as `[section : parent]`, so files written from a configuration
+	 * declaring parents must be loaded with `load_options::inheritance` to read them
+	 * back. Declarations are part of the fingerprint and of patches; `to_binary`
+	 * refuses them.
+	 * @param section The section.
+	 * @param parent The parent, or an empty name to remove the declaration.
+	 * @return A `std::expected` containing nothing on success, or
+	 * `std::errc::too_many_symbolic_link_levels` if the parent is the section itself or
+	 * one of its descendants.
+	 */
+	auto set_parent(std::string_view section, std::string_view parent)
+		-> std::expected<void, std::error_code>
+	{
+		// An acyclic chain visits each section at most once, so a longer walk can only
+		// go around a cycle that is already there
+		auto steps = m_data->sections().size() + 1;
+		for (auto ancestor = parent; !ancestor.empty(); --steps)
+		{
+			if (ancestor == section || steps == 0)
+			{
+				return std::unexpected(
+					std::make_error_code(std::errc::too_many_symbolic_link_levels));
+			}
+			const auto found = m_data->find(ancestor);
+			if (found == m_data->sections().end())
+			{
+				break;
+			}
+			ancestor = found->second.parent;
+		}
+		m_data->set_parent(section, std::string{parent});
+		return {};
+	}
+
+	/**
+	 * @brief Gets the declared parent of a section.
+	 * @param section The section.
+	 * @return A `std::optional` containing a view of the parent's name, or
+	 * `std::nullopt` if the section does not exist or declares no parent.
+	 */
+	auto get_parent(section section) const noexcept -> std::optional<std::string_view>
+	{
+		if (const auto found = m_data->find(section.value);
+			found != m_data->sections().end() && !found->second.parent.empty())
+		{
+			return std::string_view{found->second.parent};
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Lists the sections a lookup in a section searches, in order: the section
+	 * itself and then its existing ancestors. A missing parent ends the chain.
+	 * @param section The section.
+	 * @return A `std::vector` of views of the section names, valid until one of them is
+	 * removed or `load_file` or `load_stream` replaces the data, or an empty vector if
+	 * the section does not exist.
+	 */
+	auto resolution_chain(section section) const -> std::vector<std::string_view>
+	{
+		std::vector<std::string_view> chain;
+		const auto found = m_data->find(section.value);
+		if (found == m_data->sections().end())
+		{
+			return chain;
+		}
+		chain.emplace_back(found->first);
+		for (const auto *ancestor : m_data->ancestors(*found))
+		{
+			chain.emplace_back(ancestor->first);
+		}
+		return chain;
+	}
+
+	/**
+	 * @brief Starts maintaining the reverse value index.
+	 *
+	 * The index maps every value to the sections and keys holding it and is updated
+	 * with every change, so `find_by_value` takes O(1) on average plus the number of
+	 * matches instead of scanning all entries. It costs one hash table node per
+	 * distinct value. The index can also be requested with `load_options::value_index`.
+	 */
+	void enable_value_index()
+	{
+		m_data->enable_value_index();
+	}
+
+	/**
+	 * @brief Checks whether the reverse value index is maintained.
+	 * @return `true` if it is.
+	 */
+	auto has_value_index() const noexcept -> bool
+	{
+		return m_data->values() != nullptr;
+	}
+
+	/**
+	 * @brief Starts maintaining a Bloom filter of the section and key pairs present.
+	 *
+	 * Lookups of absent keys, such as optional settings probed one by one, are then
+	 * mostly answered by a single cache line read instead of walking the section and
+	 * key maps. The filter takes 2 to 4 bytes per key. New keys are added as they
+	 * are set; removed keys leave their bits behind until they outnumber the present
+	 * ones, when the filter is rebuilt. Lookups in sections declaring a parent probe
+	 * the filter once per section of the chain. The filter can also be requested with
+	 * `load_options::key_filter`.
+	 */
+	void enable_key_filter()
+	{
+		m_data->enable_key_filter();
+	}
+
+	/**
+	 * @brief Checks whether the Bloom filter of keys is maintained.
+	 * @return `true` if it is.
+	 */
+	auto has_key_filter() const noexcept -> bool
+	{
+		return m_data->key_filter() != nullptr;
+	}
+
+	/**
+	 * @brief Finds the keys holding a value, e.g. every key pointing at a host.
+	 *
+	 * Uses the reverse value index when it is maintained and scans all entries
+	 * otherwise, with the same results.
+	 * @param value The value to look for, compared exactly.
+	 * @return The sections and keys holding the value, ordered by section and key. The
+	 * names stay valid until their entries are removed or `load_file` or `load_stream`
+	 * replaces the data.
+	 */
+	auto find_by_value(std::string_view value) const
+		-> std::vector<std::pair<std::string_view, std::string_view>>
+	{
+		std::vector<std::pair<std::string_view, std::string_view>> locations;
+		if (const auto *values = m_data->values())
+		{
+			if (const auto found = values->find(value); found != values->end())
+			{
+				for (const auto &location : found->second)
+				{
+					locations.emplace_back(*location.section, *location.key);
+				}
+				std::ranges::sort(locations);
+			}
+			return locations;
+		}
+
+		for_each([&locations, value](std::string_view section, std::string_view key,
+									 std::string_view candidate) {
+			if (candidate == value)
+			{
+				locations.emplace_back(section, key);
+			}
+		});
+		return locations;
+	}
+
+	/**
+	 * @brief Retrieves a value with its `${...}` references expanded.
+	 *
+	 * `${section:key}` is replaced by the expanded value of that key, `${key}` by the
+	 * key of the same section and `${ENV:NAME}` by the environment variable `NAME`;
+	 * `$$` stands for a literal `$`. Expansion is opt-in: `get_value` returns values
+	 * as written. Results are memoized, so repeated reads cost one hash lookup, and are
+	 * invalidated exactly when a key they were built from changes or is removed, or on
+	 * reload. Environment variables are read when a result is first built; call
+	 * `invalidate_interpolations` after changing them. Safe to call concurrently with
+	 * other readers.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to expand.
+	 * @return A `std::expected` containing the expanded value, or a `std::error_code`:
+	 * `std::errc::no_such_file_or_directory` if the key, a referenced key or an
+	 * environment variable does not exist, `std::errc::too_many_symbolic_link_levels`
+	 * if references form a cycle, and `std::errc::invalid_argument` for an
+	 * unterminated `${`.
+	 */
+	auto get_interpolated(section section, key key) const
+		-> std::expected<std::string, std::error_code>
+	{
+		auto &cache = m_data->interpolations();
+		const std::scoped_lock lock{cache.mutex};
+		reference_chain chain;
+		auto result = interpolate(cache, section.value, key.value, chain);
+		if (!result.has_value())
+		{
+			return std::unexpected(result.error());
+		}
+		return **result;
+	}
+
+	/**
+	 * @brief Drops every memoized `get_interpolated` result, e.g. after environment
+	 * variables changed.
+	 */
+	void invalidate_interpolations() const
+	{
+		auto &cache = m_data->interpolations();
+		const std::scoped_lock lock{cache.mutex};
+		cache.results.clear();
+		cache.dependents.clear();
+	}
+
+	/**
+	 * @brief Gets the number of sections and keys, the payload size and the largest
+	 * section, in O(1).
+	 *
+	 * The counts are maintained with every change, so health checks need not list
+	 * sections or keys to read them. Only after the largest section lost keys is the
+	 * new largest one looked for, once, in O(sections).
+	 * @return The counts. The name of the largest section stays valid until that
+	 * section is removed or `load_file` or `load_stream` replaces the data.
+	 */
+	auto stats() const noexcept -> ini::statistics
+	{
+		return m_data->stats();
+	}
+
+	/**
+	 * @brief Gets the 64-bit fingerprint of the whole configuration, in O(1).
+	 *
+	 * Fingerprints are maintained on every change and depend only on the sections,
+	 * their declared parents, keys and values, not on how the configuration was
+	 * built, so equal configurations on different hosts have equal fingerprints. They
+	 * are hashes, not cryptographic digests: do not rely on them against deliberately
+	 * crafted input.
+	 * @return The low half of `fingerprint128()`.
+	 */
+	auto fingerprint() const noexcept -> std::uint64_t
+	{
+		return m_data->fingerprint().low;
+	}
+
+	/**
+	 * @brief Gets the 128-bit fingerprint of the whole configuration, in O(1).
+	 * @return The fingerprint.
+	 */
+	auto fingerprint128() const noexcept -> ini::fingerprint128
+	{
+		return m_data->fingerprint();
+	}
+
+	/**
+	 * @brief Gets the 64-bit fingerprint of one section, covering its name, declared
+	 * parent, keys and values.
+	 * @param section The section.
+	 * @return The fingerprint, or `std::nullopt` if the section does not exist.
+	 */
+	auto section_fingerprint(section section) const noexcept
+		-> std::optional<std::uint64_t>
+	{
+		return section_fingerprint128(section).transform(
+			[](const ini::fingerprint128 &fingerprint) { return fingerprint.low; });
+	}
+
+	/**
+	 * @brief Gets the 128-bit fingerprint of one section.
+	 * @param section The section.
+	 * @return The fingerprint, or `std::nullopt` if the section does not exist.
+	 */
+	auto section_fingerprint128(section section) const noexcept
+		-> std::optional<ini::fingerprint128>
+	{
+		const auto found = m_data->find(section.value);
+		if (found == m_data->sections().end())
+		{
+			return std::nullopt;
+		}
+		return found->second.fingerprint;
+	}
+
+	/**
+	 * @brief Compares two configurations by their 128-bit fingerprints, in O(1).
+	 * @param other The configuration to compare with.
+	 * @return `true` if both hold the same sections, parents, keys and values
+	 * (barring a fingerprint collision).
+	 */
+	auto operator==(const ini_manager &other) const noexcept -> bool
+	{
+		return m_data == other.m_data || fingerprint128() == other.fingerprint128();
+	}
+
+	/**
+	 * @brief Loads INI data from a file, replacing any existing data.
+	 * @param file_path The path to the INI file.
+	 * @param options Options controlling how the file is loaded.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto load_file(const std::string &file_path, const load_options &options = {})
+		-> std::expected<void, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::loads,
+										 detail::counter::load_nanoseconds};
+		detail::trace_scope trace{trace_event::load, file_path};
+		// Clear existing data and reset file path
+		reset_data();
+		m_file_path = file_path;
+		return trace.complete(load(file_path, options));
+	}
+
+	/**
+	 * @brief Loads INI data from an input stream, replacing any existing data.
+	 * @param istream The input stream containing INI data.
+	 * @param options Options controlling how include directives are handled.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto load_stream(std::istream &istream, const load_options &options = {})
+		-> std::expected<void, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::loads,
+										 detail::counter::load_nanoseconds};
+		detail::trace_scope trace{trace_event::load};
+		// Clear existing data and reset file path
+		reset_data();
+		m_file_path.clear();
+		parse_context context{options};
+		return trace.complete(parse(istream, context));
+	}
+
+	/**
+	 * @brief Adds INI data from an input stream to the existing data.
+	 * Existing keys in existing sections will be overwritten. New sections/keys are
+	 * added.
+	 * @param istream The input stream containing INI data to add.
+	 * @param options Options controlling how include directives are handled.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto add_from_stream(std::istream &istream, const load_options &options = {})
+		-> std::expected<void, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::merges,
+										 detail::counter::merge_nanoseconds};
+		detail::trace_scope trace{trace_event::merge};
+		// Parse directly into the existing data
+		parse_context context{options};
+		return trace.complete(parse(istream, context));
 	}
 
 	/**
-	 * @brief Sets a section in the INI data. If the section does not exist, it is
-	 * created.
-	 * @param section The name of the section to set.
+	 * @brief Adds INI data from a file to the existing data.
+	 * Existing keys in existing sections will be overwritten. New sections/keys are
+	 * added.
+	 * @param file_path The path to the INI file to add.
+	 * @param options Options controlling how the file is loaded.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
-	void set_section(const std::string &section) noexcept
+	auto add_from_file(const std::string &file_path, const load_options &options = {})
+		-> std::expected<void, std::error_code>
+	{
+		const detail::timed_count timing{detail::counter::merges,
+										 detail::counter::merge_nanoseconds};
+		detail::trace_scope trace{trace_event::merge, file_path};
+		// Load directly into the existing data
+		return trace.complete(load(file_path, options));
+	}
+
+	/**
+	 * @brief Writes the current INI data to a file.
+	 * @param file_path The path to the file to write to.
+	 * @param compression The compression of the file; by default gzip when the path
+	 * ends with ".gz" and the build has `ini_manager_WITH_ZLIB`, plain text otherwise.
+	 * Requesting `compression::gzip` without zlib fails with
+	 * `std::errc::not_supported`.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto write_file(const std::string &file_path,
+					ini::compression compression = ini::compression::detect) const
+		-> std::expected<void, std::error_code>
 	{
-		if (!m_data->contains(section))
+		detail::trace_scope trace{trace_event::write_file, file_path};
+		// Without zlib, detection keeps writing plain text as before gzip support
+		if (compression == ini::compression::none ||
+			(compression == ini::compression::detect &&
+			 (INI_MANAGER_HAS_ZLIB == 0 || !file_path.ends_with(".gz"))))
+		{
+			std::ofstream file(file_path);
+			if (!file.is_open())
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			return trace.complete(write(file));
+		}
+#if INI_MANAGER_HAS_ZLIB
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
 		{
-			// Create a new empty section only if it doesn't exist
-			(*m_data)[section] = {};
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		detail::gzip_ostreambuf buffer{file};
+		std::ostream text{&buffer};
+		if (auto result = write(text); !result.has_value())
+		{
+			return result;
+		}
+		if (!buffer.finish() || file.flush().fail())
+		{
+			return std::unexpected(std::error_code(EIO, std::system_category()));
 		}
-		// If the section already exists, do nothing.
+		trace.succeed();
+		return {};
+#else
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
 	}
 
 	/**
-	 * @brief Removes a key-value pair from a section.
-	 * @param section The section containing the key to remove.
-	 * @param key The key to remove.
-	 * @return `true` if the key was successfully removed, `false` otherwise.
+	 * @brief Compiles the current INI data into a binary image, as written by
+	 * `save_binary`.
+	 *
+	 * The image has no place for parent declarations, so configurations declaring any
+	 * are refused rather than compiled without them.
+	 * @return A `std::expected` containing the image bytes, readable with
+	 * `binary_config::from_memory`, or `std::errc::not_supported` if a section
+	 * declares a parent.
 	 */
-	auto remove_value(section section, key key) noexcept -> bool
+	auto to_binary() const -> std::expected<std::vector<std::byte>, std::error_code>
 	{
-		const auto section_it = m_data->find(std::string{section.value});
-		if (section_it != m_data->end())
+		if (m_data->has_parents())
 		{
-			// erase returns the number of elements removed (0 or 1 for map)
-			return section_it->second.erase(std::string{key.value}) > 0;
+			return std::unexpected(std::make_error_code(std::errc::not_supported));
 		}
-		return false;
+		return detail::build_binary_image(m_data->sections());
 	}
 
 	/**
-	 * @brief Removes an entire section from the INI data.
-	 * @param section The section to remove.
-	 * @return `true` if the section was successfully removed, `false` otherwise.
+	 * @brief Writes the current INI data to a file in the compiled binary format.
+	 *
+	 * The image holds a string pool, a section table and a hashed key index; it is
+	 * versioned and checksummed. Open it with `binary_config::from_binary`, which maps
+	 * the file and serves lookups without parsing.
+	 * @param file_path The path to the file to write to.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`:
+	 * `std::errc::not_supported` if a section declares a parent, see `to_binary`.
 	 */
-	auto remove_section(section section) noexcept -> bool
+	auto save_binary(const std::string &file_path) const
+		-> std::expected<void, std::error_code>
 	{
-		return m_data->erase(std::string{section.value}) > 0;
+		const auto image = to_binary();
+		if (!image.has_value())
+		{
+			return std::unexpected(image.error());
+		}
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		file.write(detail::as_chars(*image).data(),
+				   static_cast<std::streamsize>(image->size()));
+		if (file.fail())
+		{
+			return std::unexpected(std::error_code(EIO, std::system_category()));
+		}
+		return {};
 	}
 
 	/**
-	 * @brief Gets a list of all section names in the INI data.
-	 * @return A `std::vector` containing the names of all sections.
-	 * The order corresponds to the map's internal ordering (typically
-	 * alphabetical).
+	 * @brief Writes the current INI data to the file specified during loading (if any).
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 * Fails with `std::errc::operation_not_permitted` if no file path was previously
+	 * loaded or set.
 	 */
-	auto get_sections() const -> std::vector<std::string>
+	auto write_file() const -> std::expected<void, std::error_code>
 	{
-		auto key_view = std::views::keys(*m_data);
-		return {key_view.begin(), key_view.end()};
+		if (m_file_path.empty())
+		{
+			// Use a standard error code indicating invalid operation state
+			return std::unexpected(
+				std::error_code(static_cast<int>(std::errc::operation_not_permitted),
+								std::generic_category()));
+		}
+		return write_file(m_file_path);
 	}
 
 	/**
-	 * @brief Gets a list of all key names within a specific section.
-	 * @param section The section whose keys are to be retrieved.
-	 * @return A `std::vector` containing the names of all keys in the specified section.
-	 * Returns an empty vector if the section does not exist.
-	 * The order corresponds to the map's internal ordering (typically
-	 * alphabetical).
+	 * @brief Writes the INI data to an output stream.
+	 * @param ostream The output stream to write to.
+	 * @param manager The ini_manager object to write.
+	 * @return A reference to the output stream. Sets failbit on error.
 	 */
-	auto get_keys(section section) const -> std::vector<std::string>
+	friend auto operator<<(std::ostream &ostream, const ini_manager &manager)
+		-> std::ostream &
 	{
-		const auto section_it = m_data->find(std::string{section.value});
-		if (section_it != m_data->end())
+		auto result = manager.write(ostream);
+		if (!result.has_value())
 		{
-			auto key_view = std::views::keys(section_it->second);
-			return {key_view.begin(), key_view.end()};
+			// Propagate failure to the stream state
+			ostream.setstate(std::ios::failbit);
 		}
-		// Section not found, return an empty vector
-		return {};
+		return ostream;
 	}
 
 	/**
-	 * @brief Loads INI data from a file, replacing any existing data.
-	 * @param file_path The path to the INI file.
-	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 * @brief Parses INI data from an input stream.
+	 * @param istream The input stream to read from.
+	 * @param manager The ini_manager object to populate.
+	 * @return A reference to the input stream.
 	 */
-	auto load_file(const std::string &file_path) -> std::expected<void, std::error_code>
+	friend auto operator>>(std::istream &istream, ini_manager &manager) -> std::istream &
 	{
-		// Clear existing data and reset file path
-		m_data = std::make_shared<data_map>();
-		m_file_path = file_path;
-		return load(file_path);
+		parse_context context{load_options{}};
+		auto result = manager.parse(istream, context);
+		if (!result.has_value())
+		{
+			// Propagate failure to the stream state
+			istream.setstate(std::ios::failbit);
+		}
+		return istream;
 	}
 
+	friend auto make_patch(const ini_manager &base, const ini_manager &target)
+		-> std::string;
+	friend auto apply_patch(ini_manager &manager, std::string_view patch)
+		-> std::expected<void, std::error_code>;
+
+  private:
 	/**
-	 * @brief Loads INI data from an input stream, replacing any existing data.
-	 * @param istream The input stream containing INI data.
-	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 * @brief The underlying data structure storing the INI configuration.
+	 * The outer map represents sections, and the inner map represents key-value pairs
+	 * within each section. Uses shared_ptr for potential copy efficiency if needed.
 	 */
-	auto load_stream(std::istream &istream) -> std::expected<void, std::error_code>
+	std::shared_ptr<storage> m_data;
+	/**
+	 * @brief The file path of the INI file, if loaded from or intended to be saved to a
+	 * specific file.
+	 */
+	std::string m_file_path;
+
+	/**
+	 * @brief The entries whose references are being expanded, innermost last.
+	 */
+	using reference_chain = std::vector<std::pair<std::string_view, std::string_view>>;
+
+	/**
+	 * @brief Expands the references in a value, memoizing the result. Called with the
+	 * cache locked.
+	 * @param chain The entries being expanded, to detect cycles.
+	 * @return The memoized result.
+	 */
+	auto interpolate(detail::interpolation_cache &cache, std::string_view section,
+					 std::string_view key, reference_chain &chain) const
+		-> std::expected<const std::string *, std::error_code>
 	{
-		// Clear existing data and reset file path
-		m_data = std::make_shared<data_map>();
-		m_file_path.clear();
-		return parse(istream);
+		const auto id = detail::hash_entry(section, key);
+		if (const auto *cached = cache.find(id, section, key))
+		{
+			return cached;
+		}
+		const auto missing =
+			std::unexpected(std::make_error_code(std::errc::no_such_file_or_directory));
+		const auto found_section = m_data->find(section);
+		if (found_section == m_data->sections().end())
+		{
+			return missing;
+		}
+		const auto found = found_section->second.find(key);
+		if (found == found_section->second.end())
+		{
+			return missing;
+		}
+		if (std::ranges::find(chain, std::pair{section, key}) != chain.end())
+		{
+			return std::unexpected(
+				std::make_error_code(std::errc::too_many_symbolic_link_levels));
+		}
+		// Keep views of the stored names: the caller's may not outlive this call
+		section = found_section->first;
+		key = found->first;
+
+		const std::string_view raw = found->second;
+		std::string expanded;
+		std::vector<std::uint64_t> sources;
+		chain.emplace_back(section, key);
+		for (std::size_t position = 0; position < raw.size();)
+		{
+			const auto dollar = raw.find('$', position);
+			if (dollar == std::string_view::npos)
+			{
+				expanded += raw.substr(position);
+				break;
+			}
+			expanded += raw.substr(position, dollar - position);
+			const char next = dollar + 1 < raw.size() ? raw[dollar + 1] : '\0';
+			if (next != '{')
+			{
+				// `$$` is an escaped `$`; any other `$` is kept as is
+				expanded += '$';
+				position = dollar + (next == '$' ? 2 : 1);
+				continue;
+			}
+
+			position = dollar + 2;
+			const auto close = raw.find('}', position);
+			if (close == std::string_view::npos)
+			{
+				return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+			}
+			const auto reference = raw.substr(position, close - position);
+			position = close + 1;
+			const auto colon = reference.find(':');
+			const auto target_section =
+				colon == std::string_view::npos ? section : reference.substr(0, colon);
+			const auto target_key =
+				colon == std::string_view::npos ? reference : reference.substr(colon + 1);
+			if (target_section == "ENV")
+			{
+				const std::string name{target_key};
+				const char *variable = std::getenv(name.c_str());
+				if (variable == nullptr)
+				{
+					return missing;
+				}
+				expanded += variable;
+				continue;
+			}
+
+			auto value = interpolate(cache, target_section, target_key, chain);
+			if (!value.has_value())
+			{
+				return value;
+			}
+			expanded += **value;
+			sources.push_back(detail::hash_entry(target_section, target_key));
+		}
+		chain.pop_back();
+
+		cache.store(id, {std::string{section}, std::string{key}, std::move(expanded)},
+					sources);
+		return cache.find(id, section, key);
 	}
 
 	/**
-	 * @brief Adds INI data from an input stream to the existing data.
-	 * Existing keys in existing sections will be overwritten. New sections/keys are
-	 * added.
-	 * @param istream The input stream containing INI data to add.
+	 * @brief Replaces the data with empty storage maintaining the same indexes.
+	 */
+	void reset_data()
+	{
+		auto data = std::make_shared<storage>();
+		data->enable_indexes(*m_data);
+		m_data = std::move(data);
+	}
+
+	/**
+	 * @brief Appends the sections below a tree node, in tree order.
+	 */
+	static void collect_subsections(const storage::tree_node &node,
+									std::vector<std::string_view> &names)
+	{
+		for (const auto &[component, child] : node.children)
+		{
+			if (child.section != nullptr)
+			{
+				names.emplace_back(child.section->first);
+			}
+			collect_subsections(child, names);
+		}
+	}
+
+	/**
+	 * @brief State of one load shared by the main text and everything it includes.
+	 */
+	struct parse_context
+	{
+		explicit parse_context(const load_options &options)
+			: includes(options.includes), compression(options.compression),
+			  section_tree(options.section_tree), value_index(options.value_index),
+			  key_filter(options.key_filter), inheritance(options.inheritance),
+			  cache(options.shared_include_cache)
+		{
+		}
+
+		/**
+		 * @brief Creates the context of loading a file: relative includes resolve
+		 * against its directory, and including it again is a cycle.
+		 */
+		parse_context(const load_options &options, const std::string &file_path)
+			: parse_context(options)
+		{
+			std::error_code error;
+			auto path = std::filesystem::weakly_canonical(file_path, error);
+			if (error)
+			{
+				path = std::filesystem::absolute(file_path, error);
+			}
+			directory = path.parent_path();
+			stack.push_back(path.string());
+			source = file_path;
+		}
+
+		/**
+		 * @brief Whether include directives are honored.
+		 */
+		bool includes;
+		/**
+		 * @brief The compression of the loaded text and of included files.
+		 */
+		ini::compression compression;
+		/**
+		 * @brief Whether the section tree index is to be maintained.
+		 */
+		bool section_tree;
+		/**
+		 * @brief Whether the reverse value index is to be maintained.
+		 */
+		bool value_index;
+		/**
+		 * @brief Whether the Bloom filter of keys is to be maintained.
+		 */
+		bool key_filter;
+		/**
+		 * @brief Whether section headers may declare a parent.
+		 */
+		bool inheritance;
+		/**
+		 * @brief Whether the text held any include directive, honored or not.
+		 */
+		bool has_directives = false;
+		/**
+		 * @brief The directory relative include paths are resolved against.
+		 */
+		std::filesystem::path directory;
+		/**
+		 * @brief The files being included, outermost first, to detect cycles.
+		 */
+		std::vector<std::string> stack;
+		/**
+		 * @brief The include cache, created on the first include unless shared.
+		 */
+		std::shared_ptr<include_cache> cache;
+		/**
+		 * @brief The path of the loaded file as given, or empty for streams.
+		 */
+		std::string_view source;
+	};
+
+	/**
+	 * @brief Loads INI data from a file, adding to or overwriting existing data.
+	 * @param file_path The path to the INI file.
+	 * @param options Options controlling how the file is loaded.
 	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
-	auto add_from_stream(std::istream &istream) -> std::expected<void, std::error_code>
+	auto load(const std::string &file_path, const load_options &options = {})
+		-> std::expected<void, std::error_code>
 	{
-		// Parse directly into the existing data
-		return parse(istream);
+		if (options.sidecar_cache && !options.inheritance)
+		{
+			return load_cached(file_path, options);
+		}
+		std::ifstream file(file_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		parse_context context{options, file_path};
+		return parse(file, context);
 	}
 
 	/**
-	 * @brief Adds INI data from a file to the existing data.
-	 * Existing keys in existing sections will be overwritten. New sections/keys are
-	 * added.
-	 * @param file_path The path to the INI file to add.
+	 * @brief Loads INI data from a file through its sidecar cache, adding to or
+	 * overwriting existing data.
+	 *
+	 * The file is mapped once: its bytes are hashed to validate the cache and, on a
+	 * miss, parsed in place and compiled into a fresh cache. Files holding include
+	 * directives are never cached, since the cache could not notice changes to the
+	 * files they include.
+	 * @param file_path The path to the INI file.
+	 * @param options Options controlling how include directives are handled.
 	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
-	auto add_from_file(const std::string &file_path)
+	auto load_cached(const std::string &file_path, const load_options &options)
 		-> std::expected<void, std::error_code>
 	{
-		// Load directly into the existing data
-		return load(file_path);
+		std::error_code time_error;
+		const auto modified = std::filesystem::last_write_time(file_path, time_error);
+		auto source = detail::mapped_file::open(file_path);
+		if (!source.has_value())
+		{
+			return std::unexpected(source.error());
+		}
+		const auto text = detail::as_chars((*source)->bytes());
+		const auto mtime =
+			time_error ? std::int64_t{0}
+					   : static_cast<std::int64_t>(modified.time_since_epoch().count());
+		const detail::sidecar_key key{text.size(), mtime, detail::hash_bytes(text)};
+		const auto cache_path = file_path + ".inicache";
+
+		if (const auto cached = read_sidecar(cache_path, key); cached.has_value())
+		{
+			m_data->enable_indexes(options);
+			merge_binary(*cached);
+			return {};
+		}
+
+		// An empty configuration parses in place, keeping the storage its copies share;
+		// otherwise the cache needs the file's sections apart from the existing ones
+		const bool in_place = m_data->sections().empty();
+		ini_manager scratch;
+		auto &target = in_place ? *this : scratch;
+		detail::memory_streambuf buffer{text};
+		std::istream stream{&buffer};
+		parse_context context{options, file_path};
+		if (auto result = target.parse(stream, context); !result.has_value())
+		{
+			return result;
+		}
+		// Refreshing the cache is best effort; the parsed data is what matters
+		if (!context.has_directives)
+		{
+			write_sidecar(cache_path, key, target.m_data->sections());
+		}
+
+		if (in_place)
+		{
+			return {};
+		}
+		for (const auto &[section, entries] : scratch.m_data->sections())
+		{
+			const auto merged = m_data->ensure_section(section);
+			for (const auto &[key_name, value] : entries)
+			{
+				m_data->assign(merged, key_name, value);
+			}
+		}
+		return {};
 	}
 
 	/**
-	 * @brief Writes the current INI data to a file.
-	 * @param file_path The path to the file to write to.
-	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 * @brief Opens a sidecar cache if it was compiled from the expected source.
+	 * @param cache_path The path to the cache file.
+	 * @param key The identity of the current INI source.
+	 * @return The cached image, or `std::nullopt` if the cache is missing, stale or
+	 * damaged.
 	 */
-	auto write_file(const std::string &file_path) const
-		-> std::expected<void, std::error_code>
+	static auto read_sidecar(const std::string &cache_path,
+							 const detail::sidecar_key &key)
+		-> std::optional<binary_config>
 	{
-		std::ofstream file(file_path);
-		if (!file.is_open())
+		auto mapping = detail::mapped_file::open(cache_path);
+		if (!mapping.has_value())
 		{
-			return std::unexpected(std::error_code(errno, std::system_category()));
+			return std::nullopt;
+		}
+		const auto bytes = (*mapping)->bytes();
+		detail::sidecar_header header{};
+		if (bytes.size() < sizeof(header))
+		{
+			return std::nullopt;
+		}
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != detail::sidecar_magic || header.key != key)
+		{
+			return std::nullopt;
+		}
+		auto config = binary_config::from_memory(std::move(*mapping),
+												 bytes.subspan(sizeof(header)));
+		if (!config.has_value())
+		{
+			return std::nullopt;
 		}
-		return write(file);
+		return std::move(*config);
 	}
 
 	/**
-	 * @brief Writes the current INI data to the file specified during loading (if any).
-	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
-	 * Fails with `std::errc::operation_not_permitted` if no file path was previously
-	 * loaded or set.
+	 * @brief Atomically replaces a sidecar cache: the new cache is written to a
+	 * temporary file in the same directory and renamed over the old one, so
+	 * concurrent readers see either the old or the new cache, never a partial one.
+	 * @param cache_path The path to the cache file.
+	 * @param key The identity of the INI source the data was parsed from.
+	 * @param data The parsed data.
 	 */
-	auto write_file() const -> std::expected<void, std::error_code>
+	static void write_sidecar(const std::string &cache_path,
+							  const detail::sidecar_key &key, const data_map &data)
 	{
-		if (m_file_path.empty())
+		const auto image = detail::build_binary_image(data);
+		const detail::sidecar_header header{detail::sidecar_magic, key};
+#if INI_MANAGER_HAS_MMAP
+		// Created exclusively under a process-unique name, so that processes refreshing
+		// the same cache never write into each other's temporary file
+		std::string temporary_path;
+		int descriptor = -1;
+		std::random_device random;
+		for (int attempt = 0; descriptor < 0 && attempt < 16; ++attempt)
 		{
-			// Use a standard error code indicating invalid operation state
-			return std::unexpected(
-				std::error_code(static_cast<int>(std::errc::operation_not_permitted),
-								std::generic_category()));
+			temporary_path =
+				std::format("{}.{}.{:08x}.tmp", cache_path, ::getpid(), random());
+			descriptor = ::open(temporary_path.c_str(),
+								O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+			if (descriptor < 0 && errno != EEXIST)
+			{
+				return;
+			}
+		}
+		if (descriptor < 0)
+		{
+			return;
+		}
+		const auto write_all = [descriptor](std::span<const char> bytes) {
+			while (!bytes.empty())
+			{
+				const auto written = ::write(descriptor, bytes.data(), bytes.size());
+				if (written < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				if (written <= 0)
+				{
+					return false;
+				}
+				bytes = bytes.subspan(static_cast<std::size_t>(written));
+			}
+			return true;
+		};
+		const auto written =
+			write_all({reinterpret_cast<const char *>(&header), sizeof(header)}) &&
+			write_all(detail::as_chars(image));
+		if (::close(descriptor) != 0 || !written)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(temporary_path, ignored);
+			return;
+		}
+#else
+		const auto temporary_path = std::format(
+			"{}.{:x}.tmp", cache_path,
+			std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ key.source_hash);
+		{
+			std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			file.write(detail::as_chars(image).data(),
+					   static_cast<std::streamsize>(image.size()));
+			if (!file.is_open() || file.fail())
+			{
+				file.close();
+				std::error_code ignored;
+				std::filesystem::remove(temporary_path, ignored);
+				return;
+			}
+		}
+#endif
+		std::error_code error;
+		std::filesystem::rename(temporary_path, cache_path, error);
+		if (error)
+		{
+			std::filesystem::remove(temporary_path, error);
 		}
-		return write_file(m_file_path);
 	}
 
 	/**
-	 * @brief Writes the INI data to an output stream.
-	 * @param ostream The output stream to write to.
-	 * @param manager The ini_manager object to write.
-	 * @return A reference to the output stream. Sets failbit on error.
+	 * @brief Adds the contents of a binary image to the existing data.
+	 * @param config The image to merge.
 	 */
-	friend auto operator<<(std::ostream &ostream, const ini_manager &manager)
-		-> std::ostream &
+	void merge_binary(const binary_config &config)
 	{
-		auto result = manager.write(ostream);
-		if (!result.has_value())
+		for (std::uint64_t index = 0; index < config.m_header.section_count; ++index)
 		{
-			// Propagate failure to the stream state
-			ostream.setstate(std::ios::failbit);
+			const auto record = config.section_at(index);
+			const auto target = m_data->ensure_section(config.string_at(record.name));
+			const auto last = std::min(record.first_entry + record.entry_count,
+									   config.m_header.entry_count);
+			for (auto entry_index = record.first_entry; entry_index < last; ++entry_index)
+			{
+				const auto entry = config.entry_at(entry_index);
+				m_data->assign(target, config.string_at(entry.key),
+							   std::string{config.string_at(entry.value)});
+			}
 		}
-		return ostream;
 	}
 
 	/**
-	 * @brief Parses INI data from an input stream.
-	 * @param istream The input stream to read from.
-	 * @param manager The ini_manager object to populate.
-	 * @return A reference to the input stream.
+	 * @brief Reads the text of a stream, decompressing it first if needed.
+	 * @param istream The stream holding the possibly compressed text.
+	 * @param compression The compression of the stream.
+	 * @param reader Called with a stream of the plain text; returns a
+	 * `std::expected<void, std::error_code>`.
+	 * @return The result of `reader`, or the decompression error.
 	 */
-	friend auto operator>>(std::istream &istream, ini_manager &manager) -> std::istream &
+	template <typename Reader>
+	static auto read_text(std::istream &istream, ini::compression compression,
+						  Reader &&reader) -> std::expected<void, std::error_code>
 	{
-		auto result = manager.parse(istream);
-		if (!result.has_value())
+		if (compression == ini::compression::none ||
+			(compression == ini::compression::detect && !detail::is_gzip(istream)))
 		{
-			// Propagate failure to the stream state
-			istream.setstate(std::ios::failbit);
+			return std::forward<Reader>(reader)(istream);
 		}
-		return istream;
+#if INI_MANAGER_HAS_ZLIB
+		detail::gzip_istreambuf buffer{istream};
+		std::istream text{&buffer};
+		auto result = std::forward<Reader>(reader)(text);
+		if (result.has_value() && buffer.error())
+		{
+			return std::unexpected(buffer.error());
+		}
+		return result;
+#else
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
 	}
 
-  private:
-	/**
-	 * @brief The underlying data structure storing the INI configuration.
-	 * The outer map represents sections, and the inner map represents key-value pairs
-	 * within each section. Uses shared_ptr for potential copy efficiency if needed.
-	 */
-	std::shared_ptr<data_map> m_data;
-	/**
-	 * @brief The file path of the INI file, if loaded from or intended to be saved to a
-	 * specific file.
-	 */
-	std::string m_file_path;
-
 	/**
-	 * @brief Loads INI data from a file, adding to or overwriting existing data.
-	 * @param file_path The path to the INI file.
+	 * @brief Parses INI data from an input stream, adding to or overwriting existing
+	 * data.
+	 * @param istream The input stream to parse, decompressed as the context requires.
+	 * @param context The state of the current load.
 	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
-	auto load(const std::string &file_path) -> std::expected<void, std::error_code>
+	auto parse(std::istream &istream, parse_context &context)
+		-> std::expected<void, std::error_code>
 	{
-		std::ifstream file(file_path);
-		if (!file.is_open())
+		if (context.section_tree)
 		{
-			return std::unexpected(std::error_code(errno, std::system_category()));
+			m_data->enable_tree();
+		}
+		if (context.value_index)
+		{
+			m_data->enable_value_index();
+		}
+		if (context.key_filter)
+		{
+			m_data->enable_key_filter();
 		}
-		return parse(file);
+		detail::trace_scope trace{trace_event::parse, context.source};
+		return trace.complete(read_text(istream, context.compression,
+										[this, &context](std::istream &text) {
+											return parse_lines(text, context);
+										}));
 	}
 
 	/**
-	 * @brief Parses INI data from an input stream, adding to or overwriting existing
-	 * data.
+	 * @brief Parses plain INI text from an input stream, adding to or overwriting
+	 * existing data.
 	 * @param istream The input stream to parse.
+	 * @param context The state of the current load.
 	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
-	auto parse(std::istream &istream) -> std::expected<void, std::error_code>
+	auto parse_lines(std::istream &istream, parse_context &context)
+		-> std::expected<void, std::error_code>
 	{
 		std::string line;
 		std::optional<std::string> current_section;
+		// Counted once at the end, so that the loop only touches locals
+		std::uint64_t lines = 0;
+		std::uint64_t bytes = 0;
+		const auto count = [&lines, &bytes] {
+			detail::count(detail::counter::parses);
+			detail::count(detail::counter::parsed_lines, lines);
+			detail::count(detail::counter::parsed_bytes, bytes);
+			detail::trace_bytes(bytes);
+		};
 
 		while (std::getline(istream, line))
 		{
-			const std::string_view line_view = trim(line);
-
-			// Skip empty lines and comments
-			if (line_view.empty() || line_view.starts_with(';') ||
-				line_view.starts_with('#'))
-			{
-				continue;
-			}
-
-			// Section header: [SectionName]
-			if (line_view.starts_with('[') && line_view.ends_with(']'))
+			++lines;
+			bytes += line.size() + 1;
+			auto classified = detail::classify_line(line);
+			if (classified.kind == detail::line_kind::include && !context.includes)
 			{
-				if (line_view.length() < 3)
-				{ // Handle empty section "[ ]" -> treat as unnamed or error?
-				  // Current behavior: treats as empty string section name ""
-					current_section = "";
-				}
-				else
-				{
-					current_section =
-						std::string{trim(line_view.substr(1, line_view.length() - 2))};
-				}
-				// Ensure the section exists in the map (creates if new)
-				set_section(*current_section);
-				continue;
+				// Unhonored directives read as they did before includes existed
+				context.has_directives = true;
+				classified = detail::classify_line(line, false);
 			}
-
-			// Key-value pair: Key = Value
-			if (auto delimiter_pos = line_view.find('=');
-				delimiter_pos != std::string_view::npos)
+			if (auto result = apply_line(classified, current_section, context);
+				!result.has_value())
 			{
-				if (current_section.has_value())
-				{
-					auto key = trim(line_view.substr(0, delimiter_pos));
-					auto value = trim(line_view.substr(delimiter_pos + 1));
-					// Check if key is empty
-					if (!key.empty())
-					{
-						(*m_data)[*current_section][std::string{key}] =
-							std::string{value};
-					}
-				}
+				count();
+				return result;
 			}
 
 			// Check stream state *after* processing the line
 			if (istream.fail() && !istream.eof())
 			{
+				count();
 				return std::unexpected(std::error_code(EIO, std::system_category()));
 			}
 		}
 
+		count();
 		// Check final stream state after loop (e.g., if badbit is set without failbit)
 		if (istream.bad())
 		{
@@ -636,30 +4884,431 @@ class ini_manager
 	}
 
 	/**
-	 * @brief Writes the INI data to an output stream.
+	 * @brief Applies one classified line to the existing data.
+	 * @param line The classified line.
+	 * @param current_section The section entries are added to, if any.
+	 * @param context The state of the current load.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto apply_line(const detail::ini_line &line,
+					std::optional<std::string> &current_section, parse_context &context)
+		-> std::expected<void, std::error_code>
+	{
+		switch (line.kind)
+		{
+		case detail::line_kind::section:
+		{
+			auto name = line.name;
+			std::string_view parent;
+			if (const auto colon = name.find(':');
+				context.inheritance && colon != std::string_view::npos)
+			{
+				parent = trim(name.substr(colon + 1));
+				name = trim(name.substr(0, colon));
+			}
+			current_section = std::string{name};
+			// Ensure the section exists in the map (creates if new)
+			set_section(*current_section);
+			if (!parent.empty())
+			{
+				return set_parent(name, parent);
+			}
+			break;
+		}
+		case detail::line_kind::entry:
+			// Entries before the first section header are ignored
+			if (current_section.has_value())
+			{
+				m_data->assign(*current_section, line.name, std::string{line.value});
+			}
+			break;
+		case detail::line_kind::include:
+			context.has_directives = true;
+			return include(line.name, current_section, context);
+		case detail::line_kind::none:
+			break;
+		}
+		return {};
+	}
+
+	/**
+	 * @brief Parses an included file in place of its include directive.
+	 * @param path_text The path named by the directive.
+	 * @param current_section The section of the directive; it is restored afterwards.
+	 * @param context The state of the current load.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto include(std::string_view path_text,
+				 const std::optional<std::string> &current_section,
+				 parse_context &context) -> std::expected<void, std::error_code>
+	{
+		std::error_code error;
+		const auto path =
+			std::filesystem::weakly_canonical(context.directory / path_text, error);
+		if (error)
+		{
+			return std::unexpected(error);
+		}
+		const auto path_string = path.string();
+		if (std::ranges::find(context.stack, path_string) != context.stack.end())
+		{
+			return std::unexpected(
+				std::make_error_code(std::errc::too_many_symbolic_link_levels));
+		}
+		auto fragment = read_fragment(path_string, context);
+		if (!fragment.has_value())
+		{
+			return std::unexpected(fragment.error());
+		}
+
+		auto directory = path.parent_path();
+		std::swap(context.directory, directory);
+		context.stack.push_back(path_string);
+		std::optional<std::string> fragment_section = current_section;
+		std::expected<void, std::error_code> result;
+		for (const auto &token : (*fragment)->tokens)
+		{
+			result = apply_line({token.kind, token.name, token.value}, fragment_section,
+								context);
+			if (!result.has_value())
+			{
+				break;
+			}
+		}
+		context.stack.pop_back();
+		std::swap(context.directory, directory);
+		return result;
+	}
+
+	/**
+	 * @brief Gets an included file from the include cache, reading and tokenizing it
+	 * if it is not cached or has changed since.
+	 * @param path The canonical path of the file.
+	 * @param context The state of the current load.
+	 * @return A `std::expected` containing the tokenized file on success, or a
+	 * `std::error_code` on failure.
+	 */
+	static auto read_fragment(const std::string &path, parse_context &context)
+		-> std::expected<std::shared_ptr<const detail::include_fragment>, std::error_code>
+	{
+		std::error_code error;
+		const auto mtime = std::filesystem::last_write_time(path, error);
+		const auto size = error ? 0 : std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return std::unexpected(error);
+		}
+		if (!context.cache)
+		{
+			context.cache = std::make_shared<include_cache>();
+		}
+		if (auto cached = context.cache->find(path, mtime, size))
+		{
+			return cached;
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		auto fragment = std::make_shared<detail::include_fragment>();
+		fragment->mtime = mtime;
+		fragment->size = size;
+		const auto tokenize = [&fragment](std::istream &text)
+			-> std::expected<void, std::error_code> {
+			std::string line;
+			while (std::getline(text, line))
+			{
+				if (const auto classified = detail::classify_line(line);
+					classified.kind != detail::line_kind::none)
+				{
+					fragment->tokens.push_back({classified.kind,
+												std::string{classified.name},
+												std::string{classified.value}});
+				}
+			}
+			if (text.bad())
+			{
+				return std::unexpected(std::error_code(EIO, std::system_category()));
+			}
+			return {};
+		};
+		if (auto result = read_text(file, context.compression, tokenize);
+			!result.has_value())
+		{
+			return std::unexpected(result.error());
+		}
+		context.cache->store(path, fragment);
+		return fragment;
+	}
+
+	/**
+	 * @brief Writes the INI data to an output stream, with the header of a section
+	 * declaring a parent as `[section : parent]`.
 	 * @param ostream The output stream to write to.
 	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
 	 */
 	auto write(std::ostream &ostream) const -> std::expected<void, std::error_code>
 	{
-		for (const auto &[section, entries] : (*m_data))
+		detail::trace_scope trace{trace_event::write};
+		std::uint64_t bytes = 0;
+		for (const auto &[section, entries] : m_data->sections())
 		{
-			ostream << "[" << section << "]\n";
+			ostream << "[" << section;
+			bytes += section.size() + 4;
+			if (!entries.parent.empty())
+			{
+				ostream << " : " << entries.parent;
+				bytes += entries.parent.size() + 3;
+			}
+			ostream << "]\n";
 			for (const auto &[key, value] : entries)
 			{
 				ostream << key << " = " << value << "\n";
+				bytes += key.size() + value.size() + 4;
 			}
 			ostream << "\n";
 		}
+		detail::count(detail::counter::writes);
+		detail::count(detail::counter::written_bytes, bytes);
+		trace.add_bytes(bytes);
 		// Check stream state after writing all data
 		if (ostream.fail())
 		{
 			return std::unexpected(std::error_code(errno, std::system_category()));
 		}
+		trace.succeed();
 		return {};
 	}
 };
 
+/**
+ * @brief Computes the changes turning one configuration into another.
+ *
+ * The patch is compact text listing only the sections, parents and keys that differ,
+ * plus the 128-bit fingerprints of both configurations, so `apply_patch` can refuse a
+ * patch made for a different base.
+ * @param base The configuration the patch will be applied to.
+ * @param target The configuration the patch produces.
+ * @return The patch.
+ */
+inline auto make_patch(const ini_manager &base, const ini_manager &target) -> std::string
+{
+	const auto base_fingerprint = base.fingerprint128();
+	const auto target_fingerprint = target.fingerprint128();
+	std::string patch = std::format(
+		"{} {} {:016x}{:016x} {:016x}{:016x}\n", detail::patch_magic,
+		detail::patch_version, base_fingerprint.high, base_fingerprint.low,
+		target_fingerprint.high, target_fingerprint.low);
+	const auto add = [&patch](char code, std::string_view name,
+							  std::optional<std::string_view> value = std::nullopt) {
+		patch += std::format("{} {}:", code, name.size());
+		patch += name;
+		if (value.has_value())
+		{
+			patch += std::format(" {}:", value->size());
+			patch += *value;
+		}
+		patch += '\n';
+	};
+
+	// Both maps are sorted, so one merging pass finds every difference
+	const auto &old_data = base.m_data->sections();
+	const auto &new_data = target.m_data->sections();
+	auto old_section = old_data.begin();
+	auto new_section = new_data.begin();
+	while (old_section != old_data.end() || new_section != new_data.end())
+	{
+		if (new_section == new_data.end() ||
+			(old_section != old_data.end() && old_section->first < new_section->first))
+		{
+			add(']', old_section->first);
+			++old_section;
+			continue;
+		}
+		if (old_section == old_data.end() || new_section->first < old_section->first)
+		{
+			add('[', new_section->first);
+			if (!new_section->second.parent.empty())
+			{
+				add('^', new_section->second.parent);
+			}
+			for (const auto &[key, value] : new_section->second)
+			{
+				add('=', key, value);
+			}
+			++new_section;
+			continue;
+		}
+
+		const auto &old_entries = old_section->second;
+		const auto &new_entries = new_section->second;
+		bool selected = false;
+		const auto select = [&] {
+			if (!selected)
+			{
+				add('[', new_section->first);
+				selected = true;
+			}
+		};
+		if (old_entries.parent != new_entries.parent)
+		{
+			select();
+			add('^', new_entries.parent);
+		}
+		auto old_entry = old_entries.begin();
+		auto new_entry = new_entries.begin();
+		while (old_entry != old_entries.end() || new_entry != new_entries.end())
+		{
+			if (new_entry == new_entries.end() ||
+				(old_entry != old_entries.end() && old_entry->first < new_entry->first))
+			{
+				select();
+				add('-', old_entry->first);
+				++old_entry;
+			}
+			else if (old_entry == old_entries.end() ||
+					 new_entry->first < old_entry->first)
+			{
+				select();
+				add('=', new_entry->first, new_entry->second);
+				++new_entry;
+			}
+			else
+			{
+				if (old_entry->second != new_entry->second)
+				{
+					select();
+					add('=', new_entry->first, new_entry->second);
+				}
+				++old_entry;
+				++new_entry;
+			}
+		}
+		++old_section;
+		++new_section;
+	}
+	return patch;
+}
+
+/**
+ * @brief Applies a patch made by `make_patch`, touching only the sections and keys it
+ * lists.
+ *
+ * The patch is validated completely before anything is changed. Applying a patch to
+ * a configuration that already matches its result does nothing, so redelivered
+ * patches are harmless.
+ * @param manager The configuration to update.
+ * @param patch The patch.
+ * @return A `std::expected` indicating success or failure with an `std::error_code`:
+ * `std::errc::operation_not_permitted` if the configuration is neither the base nor
+ * the result of the patch, `std::errc::invalid_argument` for malformed patches,
+ * `std::errc::not_supported` for another format version and
+ * `std::errc::too_many_symbolic_link_levels` if the patch would declare a cycle of
+ * parents.
+ */
+inline auto apply_patch(ini_manager &manager, std::string_view patch)
+	-> std::expected<void, std::error_code>
+{
+	auto parsed = detail::parse_patch(patch);
+	if (!parsed.has_value())
+	{
+		return std::unexpected(parsed.error());
+	}
+	const auto fingerprint = manager.fingerprint128();
+	if (fingerprint != parsed->base)
+	{
+		if (fingerprint == parsed->result)
+		{
+			return {};
+		}
+		return std::unexpected(std::make_error_code(std::errc::operation_not_permitted));
+	}
+
+	// Replay the parent declarations first, so that a patch closing a cycle is refused
+	// like set_parent would. Only the final declarations count, since a patch may
+	// re-parent several sections one after the other.
+	auto &data = *manager.m_data;
+	std::map<std::string_view, std::string_view> parents;
+	for (const auto &[name, entries] : data.sections())
+	{
+		if (!entries.parent.empty())
+		{
+			parents.emplace(name, entries.parent);
+		}
+	}
+	std::vector<std::string_view> reparented;
+	std::string_view current;
+	for (const auto &operation : parsed->operations)
+	{
+		if (operation.code == '[')
+		{
+			current = operation.name;
+		}
+		else if (operation.code == ']')
+		{
+			parents.erase(operation.name);
+		}
+		else if (operation.code == '^')
+		{
+			if (operation.name.empty())
+			{
+				parents.erase(current);
+			}
+			else
+			{
+				parents.insert_or_assign(current, operation.name);
+				reparented.push_back(current);
+			}
+		}
+	}
+	// Every new cycle passes through a re-parented section
+	for (const auto name : reparented)
+	{
+		auto ancestor = name;
+		for (auto steps = parents.size(); steps != 0; --steps)
+		{
+			const auto found = parents.find(ancestor);
+			if (found == parents.end())
+			{
+				break;
+			}
+			ancestor = found->second;
+			if (ancestor == name)
+			{
+				return std::unexpected(
+					std::make_error_code(std::errc::too_many_symbolic_link_levels));
+			}
+		}
+	}
+
+	// Validation guarantees a section is selected before any key operation
+	ini_manager::data_map::iterator selected{};
+	for (const auto &operation : parsed->operations)
+	{
+		switch (operation.code)
+		{
+		case '[':
+			selected = data.ensure_section(operation.name);
+			break;
+		case ']':
+			data.erase_section(operation.name);
+			break;
+		case '=':
+			data.assign(selected, operation.name, std::string{operation.value});
+			break;
+		case '^':
+			data.set_parent(selected->first, std::string{operation.name});
+			break;
+		default:
+			data.erase(selected, operation.name);
+			break;
+		}
+	}
+	return {};
+}
+
 } // namespace ini
 
 #endif // INI_MANAGER_HPP
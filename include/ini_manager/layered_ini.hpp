@@ -0,0 +1,306 @@
+/**
+ * @file layered_ini.hpp
+ * @brief Resolving lookups through a stack of configuration layers.
+ *
+ * Applications often combine built-in defaults, a site file, a host file, the
+ * environment and the command line, each overriding the ones before it:
+ * @code
+ * ini::layered_ini config;
+ * config.add_layer("defaults", *ini::ini_manager::from_file("defaults.ini"));
+ * config.add_layer("site", *ini::ini_manager::from_file("/etc/app.ini"));
+ * config.add_layer("cli", cli_overrides);
+ * auto port = config.get_value<int>(ini::section{"server"}, ini::key{"port"});
+ * auto from = config.winning_layer(ini::section{"server"}, ini::key{"port"});
+ * @endcode
+ * Layers are never merged: a lookup asks each layer in turn from the top, so replacing
+ * or editing one layer leaves the others untouched and is visible at once.
+ */
+
+#ifndef INI_MANAGER_LAYERED_INI_HPP
+#define INI_MANAGER_LAYERED_INI_HPP
+
+#include "ini_manager.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace ini
+{
+
+/**
+ * @brief A value found in a layered configuration, with the layer that provided it.
+ */
+struct layer_value
+{
+	/// The name of the topmost layer defining the key.
+	std::string_view layer;
+	/// The value in that layer.
+	std::string_view value;
+};
+
+/**
+ * @brief A stack of named ini_manager layers resolved from the top down.
+ *
+ * The last added layer has the highest priority. Each layer is searched in place,
+ * parents included, and the first one defining the key wins. Lookups allocate nothing,
+ * as every layer resolves its parent chains when its sections change rather than when
+ * they are read. Layers are held by value; since copies of an ini_manager share their
+ * data, a layer can also be edited through any copy of the manager it was added from.
+ */
+class layered_ini : public detail::value_reader<layered_ini>
+{
+  public:
+	/**
+	 * @brief Adds a layer above all existing ones.
+	 * @param name The name of the layer, e.g. `defaults` or `cli`.
+	 * @param layer The configuration of the layer.
+	 * @return A `std::expected` containing nothing on success, or
+	 * `std::errc::file_exists` if a layer with that name already exists.
+	 */
+	auto add_layer(std::string name, ini_manager layer = {})
+		-> std::expected<void, std::error_code>
+	{
+		if (find_layer(name) != m_layers.end())
+		{
+			return std::unexpected(std::make_error_code(std::errc::file_exists));
+		}
+		m_layers.push_back({std::move(name), std::move(layer)});
+		return {};
+	}
+
+	/**
+	 * @brief Replaces the configuration of a layer, keeping its position.
+	 * @param name The name of the layer.
+	 * @param layer The new configuration of the layer.
+	 * @return A `std::expected` containing nothing on success, or
+	 * `std::errc::no_such_file_or_directory` if there is no layer with that name.
+	 */
+	auto set_layer(std::string_view name, ini_manager layer)
+		-> std::expected<void, std::error_code>
+	{
+		const auto found = find_layer(name);
+		if (found == m_layers.end())
+		{
+			return std::unexpected(
+				std::make_error_code(std::errc::no_such_file_or_directory));
+		}
+		found->data = std::move(layer);
+		return {};
+	}
+
+	/**
+	 * @brief Removes a layer.
+	 * @param name The name of the layer.
+	 * @return `true` if the layer was removed, `false` if it did not exist.
+	 */
+	auto remove_layer(std::string_view name) -> bool
+	{
+		const auto found = find_layer(name);
+		if (found == m_layers.end())
+		{
+			return false;
+		}
+		m_layers.erase(found);
+		return true;
+	}
+
+	/**
+	 * @brief Gets a layer for reading or in-place editing.
+	 * @param name The name of the layer.
+	 * @return A pointer to the configuration of the layer, or `nullptr` if there is no
+	 * layer with that name.
+	 */
+	auto layer(std::string_view name) noexcept -> ini_manager *
+	{
+		const auto found = find_layer(name);
+		return found == m_layers.end() ? nullptr : &found->data;
+	}
+
+	/**
+	 * @brief Gets a layer for reading.
+	 * @param name The name of the layer.
+	 * @return A pointer to the configuration of the layer, or `nullptr` if there is no
+	 * layer with that name.
+	 */
+	auto layer(std::string_view name) const noexcept -> const ini_manager *
+	{
+		const auto found = find_layer(name);
+		return found == m_layers.end() ? nullptr : &found->data;
+	}
+
+	/**
+	 * @brief Lists the layer names from the lowest to the highest priority.
+	 * @return A lazy view of `std::string_view`s, valid until a layer is added or
+	 * removed.
+	 */
+	auto layer_names() const
+	{
+		return m_layers | std::views::transform([](const entry &layer) {
+				   return std::string_view{layer.name};
+			   });
+	}
+
+	/**
+	 * @brief Gets the number of layers.
+	 */
+	auto layer_count() const noexcept -> std::size_t
+	{
+		return m_layers.size();
+	}
+
+	/**
+	 * @brief Finds the value of a key and the layer that provides it.
+	 * @param section The section containing the key.
+	 * @param key The key to look up.
+	 * @return A `std::optional` containing the value and the name of the topmost layer
+	 * defining it, valid until that layer changes, or `std::nullopt` if no layer
+	 * defines the key.
+	 */
+	auto find(section section, key key) const noexcept -> std::optional<layer_value>
+	{
+		for (const auto &layer : std::views::reverse(m_layers))
+		{
+			if (const auto value = layer.data.get_value_view(section, key);
+				value.has_value())
+			{
+				return layer_value{layer.name, *value};
+			}
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Gets the name of the layer whose value a lookup returns.
+	 * @param section The section containing the key.
+	 * @param key The key to look up.
+	 * @return A `std::optional` containing the name of the topmost layer defining the
+	 * key, or `std::nullopt` if no layer defines it.
+	 */
+	auto winning_layer(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		if (const auto found = find(section, key); found.has_value())
+		{
+			return found->layer;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Retrieves a value without copying it.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing a view of the value in the topmost layer
+	 * defining the key, or `std::nullopt` if no layer defines it.
+	 */
+	auto get_value_view(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		if (const auto found = find(section, key); found.has_value())
+		{
+			return found->value;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Gets the names of the sections defined by any layer.
+	 * @return A `std::vector` containing the section names, in alphabetical order and
+	 * without duplicates.
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		std::vector<std::string> names;
+		for (const auto &layer : m_layers)
+		{
+			for (const auto name : layer.data.sections())
+			{
+				names.emplace_back(name);
+			}
+		}
+		return sorted_unique(std::move(names));
+	}
+
+	/**
+	 * @brief Gets the names of the keys that any layer defines in a section.
+	 * @param section The section whose keys are to be retrieved.
+	 * @return A `std::vector` containing the key names, in alphabetical order and
+	 * without duplicates.
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		std::vector<std::string> names;
+		for (const auto &layer : m_layers)
+		{
+			for (const auto &[name, value] : layer.data.entries(section))
+			{
+				names.emplace_back(name);
+			}
+		}
+		return sorted_unique(std::move(names));
+	}
+
+	/**
+	 * @brief Copies the resolved configuration into a single ini_manager.
+	 *
+	 * Every key gets the value of its winning layer. The result does not follow later
+	 * changes to the layers.
+	 * @return The flattened configuration.
+	 */
+	auto flatten() const -> ini_manager
+	{
+		ini_manager flat;
+		for (const auto &layer : m_layers)
+		{
+			for (const auto section : layer.data.sections())
+			{
+				flat.set_section(std::string{section});
+			}
+			layer.data.for_each([&flat](std::string_view section, std::string_view key,
+										std::string_view value) {
+				flat.set_value(section, key, std::string{value});
+			});
+		}
+		return flat;
+	}
+
+  private:
+	struct entry
+	{
+		std::string name;
+		ini_manager data;
+	};
+
+	auto find_layer(std::string_view name) noexcept -> std::vector<entry>::iterator
+	{
+		return std::ranges::find(m_layers, name, &entry::name);
+	}
+
+	auto find_layer(std::string_view name) const noexcept
+		-> std::vector<entry>::const_iterator
+	{
+		return std::ranges::find(m_layers, name, &entry::name);
+	}
+
+	static auto sorted_unique(std::vector<std::string> names) -> std::vector<std::string>
+	{
+		std::ranges::sort(names);
+		const auto duplicates = std::ranges::unique(names);
+		names.erase(duplicates.begin(), duplicates.end());
+		return names;
+	}
+
+	std::vector<entry> m_layers;
+};
+
+} // namespace ini
+
+#endif // INI_MANAGER_LAYERED_INI_HPP
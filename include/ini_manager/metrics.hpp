@@ -0,0 +1,438 @@
+/**
+ * @file metrics.hpp
+ * @brief Operation counters of the configuration layer and their export.
+ *
+ * Builds with `ini_manager_WITH_METRICS` count lookups, hits and misses per API,
+ * parsed bytes and lines, written bytes, and the number and duration of loads and
+ * merges:
+ * @code
+ * const auto snapshot = ini::metrics();
+ * std::cout << snapshot.lookups(ini::lookup_api::get_value).misses;
+ * ini::write_prometheus(std::cout, snapshot);
+ * @endcode
+ * Each thread increments its own counters, so counting never contends; a snapshot
+ * adds them up. Without `ini_manager_WITH_METRICS` the counting compiles to nothing
+ * and snapshots hold zeros.
+ */
+
+#ifndef INI_MANAGER_METRICS_HPP
+#define INI_MANAGER_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+// Defined by the build when ini_manager_WITH_METRICS is enabled
+#if defined(INI_MANAGER_WITH_METRICS)
+#define INI_MANAGER_HAS_METRICS 1
+#else
+#define INI_MANAGER_HAS_METRICS 0
+#endif
+
+namespace ini
+{
+
+/**
+ * @brief The lookup functions counted separately.
+ */
+enum class lookup_api : std::uint8_t
+{
+	/**
+	 * @brief `ini_manager::get_value` returning a string.
+	 */
+	get_value,
+	/**
+	 * @brief `ini_manager::get_value<T>`, whether or not the conversion succeeds.
+	 */
+	get_value_as,
+	/**
+	 * @brief `ini_manager::get_value_view`.
+	 */
+	get_value_view,
+	/**
+	 * @brief `manager[section][key]` on a const manager.
+	 */
+	subscript
+};
+
+/**
+ * @brief The lookups made through one API.
+ */
+struct lookup_counts
+{
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+
+	auto lookups() const noexcept -> std::uint64_t
+	{
+		return hits + misses;
+	}
+};
+
+namespace detail
+{
+
+/**
+ * @brief The counters, in storage order.
+ */
+enum class counter : std::uint8_t
+{
+	// A hit and a miss counter per lookup_api, in its order
+	get_value_hits,
+	get_value_misses,
+	get_value_as_hits,
+	get_value_as_misses,
+	get_value_view_hits,
+	get_value_view_misses,
+	subscript_hits,
+	subscript_misses,
+	parses,
+	parsed_bytes,
+	parsed_lines,
+	writes,
+	written_bytes,
+	loads,
+	load_nanoseconds,
+	merges,
+	merge_nanoseconds,
+	count
+};
+
+inline constexpr std::size_t counter_count = static_cast<std::size_t>(counter::count);
+
+using counter_values = std::array<std::uint64_t, counter_count>;
+
+} // namespace detail
+
+/**
+ * @brief The counters added up over all threads at one point in time.
+ */
+struct metrics_snapshot
+{
+	/**
+	 * @brief The raw counters, indexed by `detail::counter`.
+	 */
+	detail::counter_values values{};
+
+	auto lookups(lookup_api api) const noexcept -> lookup_counts
+	{
+		const auto hits = static_cast<std::size_t>(api) * 2;
+		return {values[hits], values[hits + 1]};
+	}
+
+	/**
+	 * @brief The number of streams and files parsed, not counting included files.
+	 */
+	auto parses() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::parses);
+	}
+
+	auto parsed_bytes() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::parsed_bytes);
+	}
+
+	auto parsed_lines() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::parsed_lines);
+	}
+
+	/**
+	 * @brief The number of configurations written to streams and files.
+	 */
+	auto writes() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::writes);
+	}
+
+	auto written_bytes() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::written_bytes);
+	}
+
+	/**
+	 * @brief The number of configurations loaded or reloaded with `from_file`,
+	 * `from_stream`, `load_file` and `load_stream`.
+	 */
+	auto loads() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::loads);
+	}
+
+	auto load_time() const noexcept -> std::chrono::nanoseconds
+	{
+		return std::chrono::nanoseconds{get(detail::counter::load_nanoseconds)};
+	}
+
+	/**
+	 * @brief The number of merges with `add_from_file` and `add_from_stream`.
+	 */
+	auto merges() const noexcept -> std::uint64_t
+	{
+		return get(detail::counter::merges);
+	}
+
+	auto merge_time() const noexcept -> std::chrono::nanoseconds
+	{
+		return std::chrono::nanoseconds{get(detail::counter::merge_nanoseconds)};
+	}
+
+  private:
+	auto get(detail::counter counter) const noexcept -> std::uint64_t
+	{
+		return values[static_cast<std::size_t>(counter)];
+	}
+};
+
+namespace detail
+{
+
+/**
+ * @brief The counters of one thread. Only the owning thread writes them, so plain
+ * loads and stores suffice; they are atomic so that snapshots may read them.
+ */
+struct counter_block
+{
+	std::array<std::atomic<std::uint64_t>, counter_count> values{};
+	counter_block *next = nullptr;
+};
+
+/**
+ * @brief The counter blocks of the running threads, and the totals of the threads
+ * that have exited.
+ */
+class counter_registry
+{
+  public:
+	static auto instance() -> counter_registry &
+	{
+		static counter_registry registry;
+		return registry;
+	}
+
+	void attach(counter_block &block)
+	{
+		const std::scoped_lock lock{m_mutex};
+		block.next = m_blocks;
+		m_blocks = &block;
+	}
+
+	void detach(counter_block &block)
+	{
+		const std::scoped_lock lock{m_mutex};
+		for (auto **link = &m_blocks; *link != nullptr; link = &(*link)->next)
+		{
+			if (*link == &block)
+			{
+				*link = block.next;
+				break;
+			}
+		}
+		for (std::size_t index = 0; index < counter_count; ++index)
+		{
+			m_retired[index] += block.values[index].load(std::memory_order_relaxed);
+		}
+	}
+
+	auto snapshot() -> metrics_snapshot
+	{
+		const std::scoped_lock lock{m_mutex};
+		metrics_snapshot snapshot{m_retired};
+		for (const auto *block = m_blocks; block != nullptr; block = block->next)
+		{
+			for (std::size_t index = 0; index < counter_count; ++index)
+			{
+				snapshot.values[index] +=
+					block->values[index].load(std::memory_order_relaxed);
+			}
+		}
+		return snapshot;
+	}
+
+  private:
+	std::mutex m_mutex;
+	counter_block *m_blocks = nullptr;
+	counter_values m_retired{};
+};
+
+/**
+ * @brief Registers the counters of a thread for as long as it runs.
+ */
+class thread_counters
+{
+  public:
+	thread_counters()
+	{
+		counter_registry::instance().attach(m_block);
+	}
+
+	thread_counters(const thread_counters &) = delete;
+	auto operator=(const thread_counters &) -> thread_counters & = delete;
+
+	~thread_counters()
+	{
+		counter_registry::instance().detach(m_block);
+	}
+
+	auto block() noexcept -> counter_block &
+	{
+		return m_block;
+	}
+
+  private:
+	counter_block m_block;
+};
+
+/**
+ * @brief Adds to a counter of the calling thread.
+ * @param counter The counter.
+ * @param amount The amount to add.
+ */
+inline void count([[maybe_unused]] counter counter,
+				  [[maybe_unused]] std::uint64_t amount = 1) noexcept
+{
+#if INI_MANAGER_HAS_METRICS
+	thread_local thread_counters counters;
+	auto &value = counters.block().values[static_cast<std::size_t>(counter)];
+	value.store(value.load(std::memory_order_relaxed) + amount,
+				std::memory_order_relaxed);
+#endif
+}
+
+/**
+ * @brief Counts a lookup as a hit or a miss.
+ * @param api The API used.
+ * @param hit Whether the key was found.
+ */
+inline void count_lookup([[maybe_unused]] lookup_api api,
+						 [[maybe_unused]] bool hit) noexcept
+{
+#if INI_MANAGER_HAS_METRICS
+	const auto index = static_cast<std::size_t>(api) * 2 + (hit ? 0U : 1U);
+	count(static_cast<counter>(index));
+#endif
+}
+
+/**
+ * @brief Counts an operation and adds its duration when it ends.
+ */
+class timed_count
+{
+  public:
+	timed_count([[maybe_unused]] counter operations,
+				[[maybe_unused]] counter nanoseconds) noexcept
+#if INI_MANAGER_HAS_METRICS
+		: m_nanoseconds(nanoseconds), m_start(std::chrono::steady_clock::now())
+	{
+		count(operations);
+	}
+#else
+	{
+	}
+#endif
+
+	timed_count(const timed_count &) = delete;
+	auto operator=(const timed_count &) -> timed_count & = delete;
+
+	~timed_count()
+	{
+#if INI_MANAGER_HAS_METRICS
+		const auto elapsed = std::chrono::steady_clock::now() - m_start;
+		count(m_nanoseconds, static_cast<std::uint64_t>(
+								 std::chrono::nanoseconds{elapsed}.count()));
+#endif
+	}
+
+#if INI_MANAGER_HAS_METRICS
+  private:
+	counter m_nanoseconds;
+	std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+} // namespace detail
+
+/**
+ * @brief Checks whether the library was built to count operations.
+ * @return `true` with `ini_manager_WITH_METRICS`.
+ */
+constexpr auto metrics_enabled() noexcept -> bool
+{
+	return INI_MANAGER_HAS_METRICS != 0;
+}
+
+/**
+ * @brief Adds up the counters of all threads.
+ *
+ * Takes time in proportion to the number of threads that have counted something;
+ * counting itself never waits for it.
+ * @return The totals since the program started, all zero without
+ * `ini_manager_WITH_METRICS`.
+ */
+inline auto metrics() -> metrics_snapshot
+{
+#if INI_MANAGER_HAS_METRICS
+	return detail::counter_registry::instance().snapshot();
+#else
+	return {};
+#endif
+}
+
+/**
+ * @brief Writes a snapshot in the Prometheus text exposition format.
+ * @param ostream The stream to write to, e.g. the body of a `/metrics` response.
+ * @param snapshot The snapshot to write.
+ * @return A reference to the output stream.
+ */
+inline auto write_prometheus(std::ostream &ostream, const metrics_snapshot &snapshot)
+	-> std::ostream &
+{
+	const auto header = [&ostream](std::string_view name, std::string_view help) {
+		ostream << "# HELP " << name << ' ' << help << "\n# TYPE " << name
+				<< " counter\n";
+	};
+	const auto metric = [&ostream, &header](std::string_view name, std::string_view help,
+											auto value) {
+		header(name, help);
+		ostream << name << ' ' << value << '\n';
+	};
+
+	header("ini_manager_lookups_total", "Lookups by API and result.");
+	constexpr std::array<std::string_view, 4> apis{"get_value", "get_value_as",
+												   "get_value_view", "subscript"};
+	for (std::size_t api = 0; api < apis.size(); ++api)
+	{
+		const auto counts = snapshot.lookups(static_cast<lookup_api>(api));
+		ostream << "ini_manager_lookups_total{api=\"" << apis[api]
+				<< "\",result=\"hit\"} " << counts.hits << '\n';
+		ostream << "ini_manager_lookups_total{api=\"" << apis[api]
+				<< "\",result=\"miss\"} " << counts.misses << '\n';
+	}
+	metric("ini_manager_parses_total", "Streams and files parsed.", snapshot.parses());
+	metric("ini_manager_parsed_bytes_total", "Bytes of INI text parsed.",
+		   snapshot.parsed_bytes());
+	metric("ini_manager_parsed_lines_total", "Lines of INI text parsed.",
+		   snapshot.parsed_lines());
+	metric("ini_manager_writes_total", "Configurations written.", snapshot.writes());
+	metric("ini_manager_written_bytes_total", "Bytes of INI text written.",
+		   snapshot.written_bytes());
+	metric("ini_manager_loads_total", "Configurations loaded or reloaded.",
+		   snapshot.loads());
+	metric("ini_manager_load_seconds_total", "Time spent loading configurations.",
+		   std::chrono::duration<double>{snapshot.load_time()}.count());
+	metric("ini_manager_merges_total", "Configurations merged into others.",
+		   snapshot.merges());
+	metric("ini_manager_merge_seconds_total", "Time spent merging configurations.",
+		   std::chrono::duration<double>{snapshot.merge_time()}.count());
+	return ostream;
+}
+
+} // namespace ini
+
+#endif // INI_MANAGER_METRICS_HPP
@@ -0,0 +1,1068 @@
+/**
+ * @file persistent_store.hpp
+ * @brief A writable INI store living in a memory-mapped hash table file.
+ *
+ * Every update is written straight into a shared mapping of the file, so it is visible
+ * at once to every process mapping the same file and, with `msync`, durable without
+ * rewriting any INI text. The data can still be exported as INI text with `write_file`.
+ */
+
+#ifndef INI_MANAGER_PERSISTENT_STORE_HPP
+#define INI_MANAGER_PERSISTENT_STORE_HPP
+
+#include "ini_manager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if INI_MANAGER_HAS_MMAP
+#include <sys/file.h>
+#endif
+
+namespace ini
+{
+
+namespace detail
+{
+
+/**
+ * @brief Magic bytes opening every store file.
+ */
+inline constexpr std::array<char, 8> store_magic{'I', 'N', 'I', 'S', 'T', 'O', 'R', 'E'};
+
+/**
+ * @brief Version of the store file layout.
+ */
+inline constexpr std::uint32_t store_version = 2;
+
+/**
+ * @brief Header of a store file, followed by the slot table and the record heap.
+ *
+ * `heap_used`, `live_count`, `entry_count` and `retired` are shared between processes
+ * and accessed atomically. `live_count` counts every live record, `entry_count` only
+ * the keys.
+ */
+struct store_header
+{
+	std::array<char, 8> magic;
+	std::uint32_t version;
+	std::uint32_t endian_tag;
+	std::uint64_t slot_count;
+	std::uint64_t heap_offset;
+	std::uint64_t heap_capacity;
+	std::uint64_t heap_used;
+	std::uint64_t live_count;
+	std::uint64_t occupied_count;
+	std::uint64_t retired;
+	std::uint64_t entry_count;
+};
+
+static_assert(sizeof(store_header) == 80, "the slot table must stay 8-byte aligned");
+
+/**
+ * @brief One slot of the open-addressing table: the hash of the section and key and
+ * the heap offset of the current record plus `store_first_record`, or one of the
+ * markers below. Both fields are accessed atomically.
+ */
+struct store_slot
+{
+	std::uint64_t hash;
+	std::uint64_t record;
+};
+
+/**
+ * @brief Slot marker of a never used slot, which ends a probe sequence.
+ */
+inline constexpr std::uint64_t store_empty_slot = 0;
+
+/**
+ * @brief Slot marker of a removed record; probing continues past it.
+ */
+inline constexpr std::uint64_t store_removed_slot = 1;
+
+/**
+ * @brief Offset added to heap offsets stored in slots, to keep clear of the markers.
+ */
+inline constexpr std::uint64_t store_first_record = 2;
+
+/**
+ * @brief Kinds of records.
+ */
+enum class store_record_kind : std::uint32_t
+{
+	entry,
+	section
+};
+
+/**
+ * @brief Header of a record in the heap, followed by the section name, key and value.
+ * Records are immutable: an update appends a new record and repoints the slot.
+ */
+struct store_record
+{
+	std::uint32_t section_size;
+	std::uint32_t key_size;
+	std::uint32_t value_size;
+	store_record_kind kind;
+};
+
+/**
+ * @brief A record read back from the heap.
+ */
+struct store_item
+{
+	store_record_kind kind;
+	std::string_view section;
+	std::string_view key;
+	std::string_view value;
+};
+
+/**
+ * @brief Computes the slot hash of a record. Section markers hash like an entry with
+ * an empty key and are told apart by their kind.
+ */
+constexpr auto store_hash(std::string_view section, std::string_view key) noexcept
+	-> std::uint64_t
+{
+	return hash_entry(section, key);
+}
+
+/**
+ * @brief Rounds a size up to the 8-byte alignment of records.
+ */
+constexpr auto store_align(std::uint64_t size) noexcept -> std::uint64_t
+{
+	constexpr std::uint64_t alignment = 8;
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Computes the heap space taken by a record.
+ */
+constexpr auto store_record_size(std::string_view section, std::string_view key,
+								 std::string_view value) noexcept -> std::uint64_t
+{
+	return store_align(sizeof(store_record) + section.size() + key.size() + value.size());
+}
+
+#if INI_MANAGER_HAS_MMAP
+
+/**
+ * @brief An open store file and its shared, writable mapping.
+ */
+class store_file
+{
+  public:
+	store_file(int descriptor, void *address, std::size_t size) noexcept
+		: m_descriptor(descriptor), m_address(address), m_size(size)
+	{
+	}
+
+	store_file(const store_file &) = delete;
+	store_file(store_file &&) = delete;
+	auto operator=(const store_file &) -> store_file & = delete;
+	auto operator=(store_file &&) -> store_file & = delete;
+
+	~store_file()
+	{
+		::munmap(m_address, m_size);
+		::close(m_descriptor);
+	}
+
+	/**
+	 * @brief Maps an open store file, initializing it first if it is empty.
+	 * @param descriptor The descriptor of the file, locked by the caller; owned by
+	 * the result on success.
+	 * @param slot_count The number of slots of a new file, a power of two.
+	 * @param heap_capacity The heap size of a new file.
+	 * @return A `std::expected` containing the mapped file on success, or a
+	 * `std::error_code` on failure.
+	 */
+	static auto map(int descriptor, std::uint64_t slot_count, std::uint64_t heap_capacity)
+		-> std::expected<std::shared_ptr<store_file>, std::error_code>
+	{
+		struct stat info{};
+		if (::fstat(descriptor, &info) != 0)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		auto size = static_cast<std::uint64_t>(info.st_size);
+		const bool initialize = size == 0;
+		store_header header{};
+		if (initialize)
+		{
+			header = {store_magic,
+					  store_version,
+					  binary_endian_tag,
+					  slot_count,
+					  sizeof(store_header) + slot_count * sizeof(store_slot),
+					  heap_capacity,
+					  0,
+					  0,
+					  0,
+					  0,
+					  0};
+			size = header.heap_offset + heap_capacity;
+			if (::ftruncate(descriptor, static_cast<::off_t>(size)) != 0)
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+		}
+		else if (size < sizeof(store_header) ||
+				 ::pread(descriptor, &header, sizeof(header), 0) !=
+					 static_cast<::ssize_t>(sizeof(header)))
+		{
+			return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		}
+
+		if (header.magic != store_magic)
+		{
+			return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		}
+		if (header.version != store_version || header.endian_tag != binary_endian_tag)
+		{
+			return std::unexpected(std::make_error_code(std::errc::not_supported));
+		}
+		if (!std::has_single_bit(header.slot_count) ||
+			header.heap_offset !=
+				sizeof(store_header) + header.slot_count * sizeof(store_slot) ||
+			header.heap_offset + header.heap_capacity != size)
+		{
+			return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		}
+
+		void *address = ::mmap(nullptr, static_cast<std::size_t>(size),
+							   PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+		if (address == MAP_FAILED)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		auto file = std::make_shared<store_file>(descriptor, address,
+												 static_cast<std::size_t>(size));
+		if (initialize)
+		{
+			std::memcpy(address, &header, sizeof(header));
+			if (!file->sync(0, size))
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+		}
+		return file;
+	}
+
+	auto descriptor() const noexcept -> int
+	{
+		return m_descriptor;
+	}
+
+	auto header() const noexcept -> store_header &
+	{
+		return *static_cast<store_header *>(m_address);
+	}
+
+	auto slots() const noexcept -> store_slot *
+	{
+		return reinterpret_cast<store_slot *>(static_cast<std::byte *>(m_address) +
+											  sizeof(store_header));
+	}
+
+	auto heap() const noexcept -> std::byte *
+	{
+		return static_cast<std::byte *>(m_address) + header().heap_offset;
+	}
+
+	/**
+	 * @brief Accesses a shared header or slot field atomically.
+	 */
+	static auto shared(std::uint64_t &field) noexcept -> std::atomic_ref<std::uint64_t>
+	{
+		return std::atomic_ref<std::uint64_t>{field};
+	}
+
+	/**
+	 * @brief Reads the record a slot points to, checking it lies within the heap.
+	 * @param record The slot's record field, as loaded.
+	 * @return The record, or `std::nullopt` if it is out of bounds.
+	 */
+	auto item(std::uint64_t record) const noexcept -> std::optional<store_item>
+	{
+		const auto capacity = header().heap_capacity;
+		const auto offset = record - store_first_record;
+		if (offset > capacity || capacity - offset < sizeof(store_record))
+		{
+			return std::nullopt;
+		}
+		store_record head{};
+		std::memcpy(&head, heap() + offset, sizeof(head));
+		const std::uint64_t size =
+			std::uint64_t{head.section_size} + head.key_size + head.value_size;
+		if (capacity - offset - sizeof(store_record) < size)
+		{
+			return std::nullopt;
+		}
+		const auto *text = reinterpret_cast<const char *>(heap() + offset + sizeof(head));
+		return store_item{head.kind,
+						  {text, head.section_size},
+						  {text + head.section_size, head.key_size},
+						  {text + head.section_size + head.key_size, head.value_size}};
+	}
+
+	/**
+	 * @brief Writes a file range back to disk.
+	 * @param offset The start of the range.
+	 * @param size The length of the range.
+	 * @return `true` on success.
+	 */
+	auto sync(std::uint64_t offset, std::uint64_t size) const noexcept -> bool
+	{
+		const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+		const auto first = offset / page * page;
+		return ::msync(static_cast<std::byte *>(m_address) + first,
+					   static_cast<std::size_t>(offset + size - first), MS_SYNC) == 0;
+	}
+
+  private:
+	int m_descriptor;
+	void *m_address;
+	std::size_t m_size;
+};
+
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Options controlling how a persistent store is created and written.
+ */
+struct store_options
+{
+	/**
+	 * @brief The number of table slots of a new file; rounded up to a power of two.
+	 * The table grows by compaction when it is 70% full.
+	 */
+	std::uint64_t initial_slots = 1024;
+
+	/**
+	 * @brief The heap size of a new file, in bytes. The heap grows by compaction when
+	 * it is full.
+	 */
+	std::uint64_t initial_heap = std::uint64_t{1} << 20U;
+
+	/**
+	 * @brief Write every update back to disk with `msync(MS_SYNC)` before returning.
+	 * When disabled, updates are still visible to other processes at once but reach
+	 * the disk when the system writes the pages back or on `flush()`.
+	 */
+	bool durable = true;
+
+	/**
+	 * @brief The access mode of a newly created file.
+	 */
+	unsigned permissions = 0644;
+};
+
+/**
+ * @brief An INI store kept in a memory-mapped hash table file.
+ *
+ * Lookups probe an open-addressing table in the shared mapping; updates append an
+ * immutable record to the file's heap and repoint one slot atomically, so readers in
+ * any process see either the old or the new value and never take a lock. Writers are
+ * serialized across processes with a lock on the file. When the table or the heap
+ * fills up, the live records are compacted into a new file that atomically replaces
+ * the old one; every process switches to it on its next operation.
+ *
+ * A store object may be used from one thread at a time; separate objects, in the same
+ * or other processes, may share the file freely. Requires POSIX `mmap`; opening fails
+ * with `std::errc::not_supported` otherwise.
+ */
+class persistent_store : public detail::value_reader<persistent_store>
+{
+  public:
+	persistent_store(const persistent_store &) = delete;
+	persistent_store(persistent_store &&) noexcept = default;
+	auto operator=(const persistent_store &) -> persistent_store & = delete;
+	auto operator=(persistent_store &&) noexcept -> persistent_store & = default;
+	~persistent_store() = default;
+
+	/**
+	 * @brief Opens a store file, creating it if it does not exist.
+	 * @param file_path The path to the store file.
+	 * @param options Options controlling how the store is created and written.
+	 * @return A `std::expected` containing the store on success, or a
+	 * `std::error_code` on failure: `std::errc::invalid_argument` if the file is not a
+	 * store, `std::errc::not_supported` for another format version or without `mmap`.
+	 */
+	static auto open(const std::string &file_path, const store_options &options = {})
+		-> std::expected<persistent_store, std::error_code>
+	{
+		persistent_store store{file_path, options};
+		if (auto result = store.reopen(); !result.has_value())
+		{
+			return std::unexpected(result.error());
+		}
+		return store;
+	}
+
+	/**
+	 * @brief Retrieves a value without copying it.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing a view into the mapped file, or
+	 * `std::nullopt` if the section or key does not exist. The view stays valid until
+	 * the next call on the store, which may switch to a compacted file.
+	 */
+	auto get_value_view(section section, key key) const -> std::optional<std::string_view>
+	{
+		if (const auto item =
+				find(section.value, key.value, detail::store_record_kind::entry))
+		{
+			return item->value;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Checks whether a section exists, with or without keys.
+	 * @param section The section name.
+	 * @return `true` if the section exists.
+	 */
+	auto has_section(section section) const -> bool
+	{
+		return find(section.value, {}, detail::store_record_kind::section).has_value();
+	}
+
+	/**
+	 * @brief Sets a value for a given section and key, creating the section as needed.
+	 * @tparam T The type of the value to set. Must be formattable using `std::format`.
+	 * @param section The name of the section.
+	 * @param key The name of the key.
+	 * @param value The value to set.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	template <typename T>
+		requires std::formattable<T, char>
+	auto set_value(std::string_view section, std::string_view key, T value)
+		-> std::expected<void, std::error_code>
+	{
+		const auto text = std::format("{}", value);
+		return locked([&]() -> std::expected<void, std::error_code> {
+			auto result = put(section, {}, {}, detail::store_record_kind::section, false);
+			if (!result.has_value())
+			{
+				return result;
+			}
+			return put(section, key, text, detail::store_record_kind::entry, true);
+		});
+	}
+
+	/**
+	 * @brief Creates a section if it does not exist.
+	 * @param section The name of the section.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto set_section(std::string_view section) -> std::expected<void, std::error_code>
+	{
+		return locked([&] {
+			return put(section, {}, {}, detail::store_record_kind::section, false);
+		});
+	}
+
+	/**
+	 * @brief Removes a key-value pair from a section.
+	 * @param section The section containing the key to remove.
+	 * @param key The key to remove.
+	 * @return A `std::expected` containing whether the key existed, or a
+	 * `std::error_code` on failure.
+	 */
+	auto remove_value(section section, key key) -> std::expected<bool, std::error_code>
+	{
+		return locked([&] {
+			return erase(section.value, key.value, detail::store_record_kind::entry);
+		});
+	}
+
+	/**
+	 * @brief Removes a section with all its keys. Scans the whole table.
+	 * @param section The section to remove.
+	 * @return A `std::expected` containing whether the section existed, or a
+	 * `std::error_code` on failure.
+	 */
+	auto remove_section(section section) -> std::expected<bool, std::error_code>
+	{
+		return locked([&]() -> std::expected<bool, std::error_code> {
+			return erase_if([&](const detail::store_item &item) {
+				return item.section == section.value;
+			});
+		});
+	}
+
+	/**
+	 * @brief Gets the number of keys in the store, kept in the file header.
+	 * @return The number of keys.
+	 */
+	auto size() const -> std::size_t
+	{
+#if INI_MANAGER_HAS_MMAP
+		if (!refresh().has_value())
+		{
+			return 0;
+		}
+		return static_cast<std::size_t>(
+			detail::store_file::shared(m_file->header().entry_count)
+				.load(std::memory_order_relaxed));
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * @brief Gets all section names, in alphabetical order. Scans the whole table.
+	 * @return A `std::vector` containing the names of all sections.
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		std::vector<std::string> sections;
+		for_each([&sections](const detail::store_item &item) {
+			if (item.kind == detail::store_record_kind::section)
+			{
+				sections.emplace_back(item.section);
+			}
+		});
+		std::ranges::sort(sections);
+		return sections;
+	}
+
+	/**
+	 * @brief Gets all key names of a section, in alphabetical order. Scans the whole
+	 * table.
+	 * @param section The section whose keys are to be retrieved.
+	 * @return A `std::vector` containing the names of the keys.
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		std::vector<std::string> keys;
+		for_each([&](const detail::store_item &item) {
+			if (item.kind == detail::store_record_kind::entry &&
+				item.section == section.value)
+			{
+				keys.emplace_back(item.key);
+			}
+		});
+		std::ranges::sort(keys);
+		return keys;
+	}
+
+	/**
+	 * @brief Copies the store into an in-memory `ini_manager`.
+	 * @return The copy.
+	 */
+	auto to_manager() const -> ini_manager
+	{
+		ini_manager manager;
+		for_each([&manager](const detail::store_item &item) {
+			if (item.kind == detail::store_record_kind::section)
+			{
+				manager.set_section(std::string{item.section});
+			}
+			else
+			{
+				manager.set_value(item.section, item.key, item.value);
+			}
+		});
+		return manager;
+	}
+
+	/**
+	 * @brief Exports the store as an INI file.
+	 * @param file_path The path to the file to write to.
+	 * @param compression The compression of the file, as for
+	 * `ini_manager::write_file`.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto write_file(const std::string &file_path,
+					ini::compression compression = ini::compression::detect) const
+		-> std::expected<void, std::error_code>
+	{
+		return to_manager().write_file(file_path, compression);
+	}
+
+	/**
+	 * @brief Writes the whole file back to disk, for stores opened without
+	 * `store_options::durable`.
+	 * @return A `std::expected` indicating success or failure with an `std::error_code`.
+	 */
+	auto flush() -> std::expected<void, std::error_code>
+	{
+#if INI_MANAGER_HAS_MMAP
+		const auto &header = m_file->header();
+		if (!m_file->sync(0, header.heap_offset + header.heap_capacity))
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		return {};
+#else
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
+	}
+
+  private:
+	std::string m_file_path;
+	store_options m_options;
+#if INI_MANAGER_HAS_MMAP
+	/**
+	 * @brief The current file; replaced when another process compacted the store.
+	 */
+	mutable std::shared_ptr<detail::store_file> m_file;
+#endif
+
+	persistent_store(std::string file_path, const store_options &options)
+		: m_file_path(std::move(file_path)), m_options(options)
+	{
+		m_options.initial_slots = std::bit_ceil(std::max<std::uint64_t>(
+			m_options.initial_slots, std::uint64_t{16}));
+		m_options.initial_heap = std::max<std::uint64_t>(
+			detail::store_align(m_options.initial_heap), std::uint64_t{4096});
+	}
+
+#if INI_MANAGER_HAS_MMAP
+	/**
+	 * @brief Opens the current file at the store path.
+	 */
+	auto reopen() const -> std::expected<void, std::error_code>
+	{
+		for (;;)
+		{
+			const int descriptor =
+				::open(m_file_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC,
+					   static_cast<::mode_t>(m_options.permissions));
+			if (descriptor < 0)
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			// Initializing a new file must not race with another process doing the same
+			if (::flock(descriptor, LOCK_EX) != 0)
+			{
+				const auto error = std::error_code(errno, std::system_category());
+				::close(descriptor);
+				return std::unexpected(error);
+			}
+			auto file = detail::store_file::map(descriptor, m_options.initial_slots,
+												m_options.initial_heap);
+			::flock(descriptor, LOCK_UN);
+			if (!file.has_value())
+			{
+				::close(descriptor);
+				return std::unexpected(file.error());
+			}
+			m_file = std::move(*file);
+			// The path may have been replaced while it was being opened
+			if (!is_retired())
+			{
+				return {};
+			}
+		}
+	}
+
+	auto is_retired() const noexcept -> bool
+	{
+		return detail::store_file::shared(m_file->header().retired)
+				   .load(std::memory_order_acquire) != 0;
+	}
+
+	/**
+	 * @brief Switches to the compacted file if the current one was replaced.
+	 */
+	auto refresh() const -> std::expected<void, std::error_code>
+	{
+		return is_retired() ? reopen() : std::expected<void, std::error_code>{};
+	}
+
+	/**
+	 * @brief Runs an update holding the writer lock of the current file.
+	 */
+	template <typename Function> auto locked(Function &&function) -> decltype(function())
+	{
+		for (;;)
+		{
+			if (auto result = refresh(); !result.has_value())
+			{
+				return std::unexpected(result.error());
+			}
+			const auto file = m_file;
+			if (::flock(file->descriptor(), LOCK_EX) != 0)
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			if (is_retired())
+			{
+				// Another process compacted the store while we waited for the lock
+				::flock(file->descriptor(), LOCK_UN);
+				continue;
+			}
+			auto result = function();
+			// A compaction switched to a new file, whose lock is held too
+			if (m_file != file)
+			{
+				::flock(m_file->descriptor(), LOCK_UN);
+			}
+			::flock(file->descriptor(), LOCK_UN);
+			return result;
+		}
+	}
+
+	/**
+	 * @brief Finds the live record of a section and key.
+	 */
+	auto find(std::string_view section, std::string_view key,
+			  detail::store_record_kind kind) const -> std::optional<detail::store_item>
+	{
+		if (!refresh().has_value())
+		{
+			return std::nullopt;
+		}
+		const auto &file = *m_file;
+		const auto hash = detail::store_hash(section, key);
+		const auto mask = file.header().slot_count - 1;
+		for (std::uint64_t probe = 0; probe <= mask; ++probe)
+		{
+			auto &slot = file.slots()[(hash + probe) & mask];
+			const auto record =
+				detail::store_file::shared(slot.record).load(std::memory_order_acquire);
+			if (record == detail::store_empty_slot)
+			{
+				break;
+			}
+			if (record == detail::store_removed_slot ||
+				detail::store_file::shared(slot.hash).load(std::memory_order_relaxed) !=
+					hash)
+			{
+				continue;
+			}
+			const auto item = file.item(record);
+			if (item.has_value() && item->kind == kind && item->section == section &&
+				item->key == key)
+			{
+				return item;
+			}
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Calls a function for every live record.
+	 */
+	template <typename Function> void for_each(Function &&function) const
+	{
+		if (!refresh().has_value())
+		{
+			return;
+		}
+		const auto &file = *m_file;
+		for (std::uint64_t index = 0; index < file.header().slot_count; ++index)
+		{
+			const auto record = detail::store_file::shared(file.slots()[index].record)
+									.load(std::memory_order_acquire);
+			if (record >= detail::store_first_record)
+			{
+				if (const auto item = file.item(record))
+				{
+					function(*item);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Inserts or replaces a record. Called with the writer lock held.
+	 * @param replace Whether an existing record is replaced; otherwise it is kept.
+	 */
+	auto put(std::string_view section, std::string_view key, std::string_view value,
+			 detail::store_record_kind kind, bool replace)
+		-> std::expected<void, std::error_code>
+	{
+		const auto size = detail::store_record_size(section, key, value);
+		auto *file = m_file.get();
+		auto &header = file->header();
+		constexpr std::uint64_t max_load_percent = 70;
+		if (header.heap_used + size > header.heap_capacity ||
+			(header.occupied_count + 1) * 100 > header.slot_count * max_load_percent)
+		{
+			if (auto result = compact(size); !result.has_value())
+			{
+				return result;
+			}
+			return put(section, key, value, kind, replace);
+		}
+
+		const auto hash = detail::store_hash(section, key);
+		const auto mask = header.slot_count - 1;
+		auto index = hash & mask;
+		for (;; index = (index + 1) & mask)
+		{
+			auto &slot = file->slots()[index];
+			if (slot.record == detail::store_empty_slot)
+			{
+				break;
+			}
+			if (slot.record == detail::store_removed_slot || slot.hash != hash)
+			{
+				continue;
+			}
+			const auto item = file->item(slot.record);
+			if (item.has_value() && item->kind == kind && item->section == section &&
+				item->key == key)
+			{
+				if (!replace || item->value == value)
+				{
+					return {};
+				}
+				break;
+			}
+		}
+
+		// Write the record, then publish it by repointing the slot
+		auto &slot = file->slots()[index];
+		const bool inserted = slot.record == detail::store_empty_slot;
+		const auto offset = header.heap_used;
+		const detail::store_record head{static_cast<std::uint32_t>(section.size()),
+										static_cast<std::uint32_t>(key.size()),
+										static_cast<std::uint32_t>(value.size()), kind};
+		auto *target = file->heap() + offset;
+		std::memcpy(target, &head, sizeof(head));
+		target += sizeof(head);
+		std::memcpy(target, section.data(), section.size());
+		std::memcpy(target + section.size(), key.data(), key.size());
+		std::memcpy(target + section.size() + key.size(), value.data(), value.size());
+		detail::store_file::shared(header.heap_used)
+			.store(offset + size, std::memory_order_release);
+		if (inserted)
+		{
+			detail::store_file::shared(slot.hash).store(hash, std::memory_order_relaxed);
+			++header.occupied_count;
+			detail::store_file::shared(header.live_count)
+				.fetch_add(1, std::memory_order_relaxed);
+			if (kind == detail::store_record_kind::entry)
+			{
+				detail::store_file::shared(header.entry_count)
+					.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		detail::store_file::shared(slot.record)
+			.store(offset + detail::store_first_record, std::memory_order_release);
+
+		const auto slot_offset = sizeof(detail::store_header) + index * sizeof(slot);
+		if (m_options.durable && (!file->sync(header.heap_offset + offset, size) ||
+								  !file->sync(slot_offset, sizeof(slot)) ||
+								  !file->sync(0, sizeof(header))))
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		return {};
+	}
+
+	/**
+	 * @brief Removes the live record of a section and key, probing from its hash slot
+	 * like `find` and `put`. Called with the writer lock held.
+	 * @return Whether the record existed.
+	 */
+	auto erase(std::string_view section, std::string_view key,
+			   detail::store_record_kind kind) -> std::expected<bool, std::error_code>
+	{
+		auto &file = *m_file;
+		auto &header = file.header();
+		const auto hash = detail::store_hash(section, key);
+		const auto mask = header.slot_count - 1;
+		for (std::uint64_t probe = 0; probe <= mask; ++probe)
+		{
+			const auto index = (hash + probe) & mask;
+			auto &slot = file.slots()[index];
+			if (slot.record == detail::store_empty_slot)
+			{
+				break;
+			}
+			if (slot.record == detail::store_removed_slot || slot.hash != hash)
+			{
+				continue;
+			}
+			const auto item = file.item(slot.record);
+			if (!item.has_value() || item->kind != kind || item->section != section ||
+				item->key != key)
+			{
+				continue;
+			}
+			detail::store_file::shared(slot.record)
+				.store(detail::store_removed_slot, std::memory_order_release);
+			detail::store_file::shared(header.live_count)
+				.fetch_sub(1, std::memory_order_relaxed);
+			if (kind == detail::store_record_kind::entry)
+			{
+				detail::store_file::shared(header.entry_count)
+					.fetch_sub(1, std::memory_order_relaxed);
+			}
+			const auto slot_offset = sizeof(detail::store_header) + index * sizeof(slot);
+			if (m_options.durable && (!file.sync(slot_offset, sizeof(slot)) ||
+									  !file.sync(0, sizeof(header))))
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Removes every live record matching a predicate, scanning the whole table.
+	 * Called with the writer lock held.
+	 * @return Whether any record was removed.
+	 */
+	template <typename Predicate>
+	auto erase_if(Predicate &&predicate) -> std::expected<bool, std::error_code>
+	{
+		auto &file = *m_file;
+		auto &header = file.header();
+		bool erased = false;
+		for (std::uint64_t index = 0; index < header.slot_count; ++index)
+		{
+			auto &slot = file.slots()[index];
+			if (slot.record < detail::store_first_record)
+			{
+				continue;
+			}
+			const auto item = file.item(slot.record);
+			if (item.has_value() && predicate(*item))
+			{
+				detail::store_file::shared(slot.record)
+					.store(detail::store_removed_slot, std::memory_order_release);
+				detail::store_file::shared(header.live_count)
+					.fetch_sub(1, std::memory_order_relaxed);
+				if (item->kind == detail::store_record_kind::entry)
+				{
+					detail::store_file::shared(header.entry_count)
+						.fetch_sub(1, std::memory_order_relaxed);
+				}
+				erased = true;
+			}
+		}
+		if (erased && m_options.durable && !file.sync(0, header.heap_offset))
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		return erased;
+	}
+
+	/**
+	 * @brief Copies the live records into a new, larger file that atomically replaces
+	 * the current one, then retires the current one. Called with the writer lock held;
+	 * returns holding the lock of the new file as well.
+	 * @param incoming The heap space needed by the pending record.
+	 */
+	auto compact(std::uint64_t incoming) -> std::expected<void, std::error_code>
+	{
+		const auto old_file = m_file;
+		const auto &old_header = old_file->header();
+		const auto live = detail::store_file::shared(old_file->header().live_count)
+							  .load(std::memory_order_relaxed);
+		std::uint64_t live_bytes = 0;
+		for_each([&live_bytes](const detail::store_item &item) {
+			live_bytes += detail::store_record_size(item.section, item.key, item.value);
+		});
+		const auto slot_count = std::max(
+			m_options.initial_slots, std::bit_ceil((live + 1) * 2 * 100 / 70 + 1));
+		const auto needed = detail::store_align((live_bytes + incoming) * 2);
+		const auto heap_capacity =
+			std::max({m_options.initial_heap, needed, old_header.heap_capacity});
+
+		// Created exclusively under an unpredictable name, so that a file planted at
+		// the temporary path is never truncated or written through
+		std::string temporary_path;
+		int descriptor = -1;
+		std::random_device random;
+		for (int attempt = 0; descriptor < 0 && attempt < 16; ++attempt)
+		{
+			temporary_path = std::format("{}.{}.{:08x}.compact", m_file_path,
+										 ::getpid(), random());
+			descriptor =
+				::open(temporary_path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+					   static_cast<::mode_t>(m_options.permissions));
+			if (descriptor < 0 && errno != EEXIST)
+			{
+				break;
+			}
+		}
+		if (descriptor < 0)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		auto mapped = detail::store_file::map(descriptor, slot_count, heap_capacity);
+		if (!mapped.has_value())
+		{
+			::close(descriptor);
+			::unlink(temporary_path.c_str());
+			return std::unexpected(mapped.error());
+		}
+		::flock(descriptor, LOCK_EX);
+
+		// Fill the new file without syncing every record, then sync it once
+		const auto new_file = std::move(*mapped);
+		const bool durable = m_options.durable;
+		m_options.durable = false;
+		m_file = new_file;
+		std::expected<void, std::error_code> result;
+		for (std::uint64_t index = 0; index < old_header.slot_count && result; ++index)
+		{
+			const auto record = old_file->slots()[index].record;
+			if (record < detail::store_first_record)
+			{
+				continue;
+			}
+			if (const auto item = old_file->item(record))
+			{
+				result = put(item->section, item->key, item->value, item->kind, true);
+			}
+		}
+		m_options.durable = durable;
+		if (result.has_value() &&
+			(!new_file->sync(0, new_file->header().heap_offset + heap_capacity) ||
+			 ::rename(temporary_path.c_str(), m_file_path.c_str()) != 0))
+		{
+			result = std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		if (!result.has_value())
+		{
+			m_file = old_file;
+			::unlink(temporary_path.c_str());
+			return result;
+		}
+
+		detail::store_file::shared(old_file->header().retired)
+			.store(1, std::memory_order_release);
+		old_file->sync(0, sizeof(detail::store_header));
+		return {};
+	}
+#else
+	auto reopen() const -> std::expected<void, std::error_code>
+	{
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+	}
+#endif
+};
+
+} // namespace ini
+
+#endif // INI_MANAGER_PERSISTENT_STORE_HPP
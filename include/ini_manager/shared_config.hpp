@@ -0,0 +1,480 @@
+/**
+ * @file shared_config.hpp
+ * @brief Publishing frozen configurations to POSIX shared memory for many readers.
+ *
+ * One process compiles an ini_manager into a position-independent binary image and
+ * publishes it under a name; any number of processes attach to it and serve lookups
+ * straight from the shared pages, with no parsing and no private copy of the data.
+ * Every publication gets a new generation; readers attached to an older generation
+ * keep a valid mapping until they re-attach.
+ */
+
+#ifndef INI_MANAGER_SHARED_CONFIG_HPP
+#define INI_MANAGER_SHARED_CONFIG_HPP
+
+#include "ini_manager.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if INI_MANAGER_HAS_MMAP
+#include <sys/file.h>
+#endif
+
+namespace ini
+{
+
+namespace detail
+{
+
+/**
+ * @brief Control block of a published configuration: the magic bytes "INICNTRL"
+ * and the generation currently published (zero before the first publication,
+ * `shared_unlinked_generation` once unlinked).
+ */
+struct shared_control
+{
+	std::uint64_t magic;
+	std::uint64_t generation;
+};
+
+/**
+ * @brief Magic value of an initialized control block.
+ */
+inline constexpr std::uint64_t shared_control_magic = 0x4C5254434E494E49ULL;
+
+/**
+ * @brief Generation left in the control block of an unlinked configuration, so that
+ * readers still mapping it stop being current even if the name is published again.
+ */
+inline constexpr std::uint64_t shared_unlinked_generation = UINT64_MAX;
+
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free,
+			  "the generation must be shared without locks between processes");
+
+/**
+ * @brief Gets the shared memory name of the control block of a configuration.
+ */
+inline auto shared_control_name(std::string_view name) -> std::string
+{
+	return std::format("/{}", name);
+}
+
+/**
+ * @brief Gets the shared memory name of one generation of a configuration.
+ */
+inline auto shared_segment_name(std::string_view name, std::uint64_t generation)
+	-> std::string
+{
+	return std::format("/{}.{}", name, generation);
+}
+
+/**
+ * @brief Checks that a configuration name is usable as a shared memory object name.
+ */
+inline auto is_shared_name(std::string_view name) noexcept -> bool
+{
+	return !name.empty() && name.find('/') == std::string_view::npos;
+}
+
+#if INI_MANAGER_HAS_MMAP
+
+/**
+ * @brief Owning mapping of a shared memory object.
+ */
+class shared_mapping
+{
+  public:
+	shared_mapping(void *address, std::size_t size) noexcept
+		: m_address(address), m_size(size)
+	{
+	}
+
+	shared_mapping(const shared_mapping &) = delete;
+	shared_mapping(shared_mapping &&) = delete;
+	auto operator=(const shared_mapping &) -> shared_mapping & = delete;
+	auto operator=(shared_mapping &&) -> shared_mapping & = delete;
+
+	~shared_mapping()
+	{
+		::munmap(m_address, m_size);
+	}
+
+	/**
+	 * @brief Maps an open shared memory object.
+	 * @param descriptor The descriptor of the object; it can be closed afterwards.
+	 * @param size The number of bytes to map.
+	 * @param writable Whether the mapping must be writable.
+	 * @return A `std::expected` containing the mapping on success, or a
+	 * `std::error_code` on failure.
+	 */
+	static auto map(int descriptor, std::size_t size, bool writable)
+		-> std::expected<std::shared_ptr<shared_mapping>, std::error_code>
+	{
+		void *address =
+			::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+				   MAP_SHARED, descriptor, 0);
+		if (address == MAP_FAILED)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		return std::make_shared<shared_mapping>(address, size);
+	}
+
+	/**
+	 * @brief Gets the mapped bytes.
+	 */
+	auto bytes() const noexcept -> std::span<std::byte>
+	{
+		return {static_cast<std::byte *>(m_address), m_size};
+	}
+
+	/**
+	 * @brief Accesses the generation of a mapped control block.
+	 */
+	auto generation() const noexcept -> std::atomic_ref<std::uint64_t>
+	{
+		return std::atomic_ref<std::uint64_t>{
+			static_cast<shared_control *>(m_address)->generation};
+	}
+
+  private:
+	void *m_address;
+	std::size_t m_size;
+};
+
+/**
+ * @brief Closes a file descriptor when leaving scope.
+ */
+class descriptor_guard
+{
+  public:
+	explicit descriptor_guard(int descriptor) noexcept : m_descriptor(descriptor)
+	{
+	}
+
+	descriptor_guard(const descriptor_guard &) = delete;
+	descriptor_guard(descriptor_guard &&) = delete;
+	auto operator=(const descriptor_guard &) -> descriptor_guard & = delete;
+	auto operator=(descriptor_guard &&) -> descriptor_guard & = delete;
+
+	~descriptor_guard()
+	{
+		::close(m_descriptor);
+	}
+
+  private:
+	int m_descriptor;
+};
+
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Publishes a configuration to shared memory under a name.
+ *
+ * The data is compiled into a new generation segment (`/<name>.<generation>`, under
+ * `/dev/shm` on Linux), then the control block (`/<name>`) is switched to it and the
+ * previous generation is unlinked. Readers that already attached to the previous
+ * generation keep using it undisturbed; the memory is released when the last of them
+ * detaches. Concurrent publishers are serialized with a lock on the control block.
+ * @param name The configuration name. Must not contain '/'; keep it short, since
+ * some systems limit shared memory names to about 30 characters.
+ * @param manager The configuration to publish.
+ * @param permissions The access mode of newly created shared memory objects.
+ * @return A `std::expected` containing the published generation on success, or a
+ * `std::error_code` on failure (`std::errc::not_supported` without POSIX shared
+ * memory or if a section declares a parent, see `ini_manager::to_binary`).
+ */
+inline auto publish_shared(const std::string &name, const ini_manager &manager,
+						   unsigned permissions = 0600)
+	-> std::expected<std::uint64_t, std::error_code>
+{
+	if (!detail::is_shared_name(name))
+	{
+		return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+	}
+#if INI_MANAGER_HAS_MMAP
+	const auto system_error = [] {
+		return std::unexpected(std::error_code(errno, std::system_category()));
+	};
+	const auto image = manager.to_binary();
+	if (!image.has_value())
+	{
+		return std::unexpected(image.error());
+	}
+
+	const auto mode = static_cast<::mode_t>(permissions);
+	const int control_descriptor =
+		::shm_open(detail::shared_control_name(name).c_str(), O_CREAT | O_RDWR, mode);
+	if (control_descriptor < 0)
+	{
+		return system_error();
+	}
+	// Closing the descriptor also releases the publisher lock
+	const detail::descriptor_guard control_guard{control_descriptor};
+	struct stat info{};
+	if (::flock(control_descriptor, LOCK_EX) != 0 ||
+		::fstat(control_descriptor, &info) != 0 ||
+		(static_cast<std::size_t>(info.st_size) < sizeof(detail::shared_control) &&
+		 ::ftruncate(control_descriptor, sizeof(detail::shared_control)) != 0))
+	{
+		return system_error();
+	}
+	auto control = detail::shared_mapping::map(control_descriptor,
+											   sizeof(detail::shared_control), true);
+	if (!control.has_value())
+	{
+		return std::unexpected(control.error());
+	}
+	auto *block = reinterpret_cast<detail::shared_control *>((*control)->bytes().data());
+	if (block->magic != detail::shared_control_magic)
+	{
+		// Freshly created: ftruncate zero-filled it, so no generation is published yet
+		block->magic = detail::shared_control_magic;
+	}
+	const auto previous = (*control)->generation().load(std::memory_order_acquire);
+	if (previous == detail::shared_unlinked_generation)
+	{
+		// Unlinked while this publisher waited for the lock; the name is free again
+		return std::unexpected(
+			std::make_error_code(std::errc::resource_unavailable_try_again));
+	}
+	const auto next = previous + 1;
+	const auto segment = detail::shared_segment_name(name, next);
+
+	// A leftover of a publisher that crashed before switching generations is stale
+	::shm_unlink(segment.c_str());
+	const int segment_descriptor =
+		::shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, mode);
+	if (segment_descriptor < 0)
+	{
+		return system_error();
+	}
+	{
+		const detail::descriptor_guard segment_guard{segment_descriptor};
+		if (::ftruncate(segment_descriptor, static_cast<::off_t>(image->size())) != 0)
+		{
+			const auto error = system_error();
+			::shm_unlink(segment.c_str());
+			return error;
+		}
+		auto data = detail::shared_mapping::map(segment_descriptor, image->size(), true);
+		if (!data.has_value())
+		{
+			::shm_unlink(segment.c_str());
+			return std::unexpected(data.error());
+		}
+		std::memcpy((*data)->bytes().data(), image->data(), image->size());
+	}
+
+	(*control)->generation().store(next, std::memory_order_release);
+	if (previous != 0)
+	{
+		::shm_unlink(detail::shared_segment_name(name, previous).c_str());
+	}
+	return next;
+#else
+	static_cast<void>(manager);
+	static_cast<void>(permissions);
+	return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
+}
+
+/**
+ * @brief Removes a published configuration. Attached readers keep their data but
+ * are no longer current.
+ * @param name The configuration name.
+ * @return A `std::expected` indicating success or failure with an `std::error_code`.
+ */
+inline auto unlink_shared(const std::string &name) -> std::expected<void, std::error_code>
+{
+	if (!detail::is_shared_name(name))
+	{
+		return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+	}
+#if INI_MANAGER_HAS_MMAP
+	const auto control_name = detail::shared_control_name(name);
+	const int control_descriptor = ::shm_open(control_name.c_str(), O_RDWR, 0);
+	if (control_descriptor < 0)
+	{
+		return std::unexpected(std::error_code(errno, std::system_category()));
+	}
+	const detail::descriptor_guard control_guard{control_descriptor};
+	::flock(control_descriptor, LOCK_EX);
+	if (auto control = detail::shared_mapping::map(control_descriptor,
+												   sizeof(detail::shared_control), true);
+		control.has_value())
+	{
+		// Attached readers map this block, not the name, so it must record the unlink
+		const auto generation = (*control)->generation().exchange(
+			detail::shared_unlinked_generation, std::memory_order_acq_rel);
+		if (generation != 0 && generation != detail::shared_unlinked_generation)
+		{
+			::shm_unlink(detail::shared_segment_name(name, generation).c_str());
+		}
+	}
+	::shm_unlink(control_name.c_str());
+	return {};
+#else
+	return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
+}
+
+/**
+ * @brief A configuration attached from shared memory.
+ *
+ * Offers the full read API of `binary_config`, served from pages shared by every
+ * attached process. The attached generation never changes underneath the reader;
+ * use `is_current` to notice a newer publication and `attach` again to switch.
+ */
+class shared_config : public binary_config
+{
+  public:
+	/**
+	 * @brief Attaches to the currently published generation of a configuration.
+	 * @param name The configuration name passed to `publish_shared`.
+	 * @param verify_checksum Whether to check the image checksum, which reads every
+	 * page; attaching is O(1) otherwise.
+	 * @return A `std::expected` containing the shared_config object on success, or a
+	 * `std::error_code` on failure: `std::errc::no_such_file_or_directory` if nothing
+	 * is published, `std::errc::not_supported` without POSIX shared memory.
+	 */
+	static auto attach(const std::string &name, bool verify_checksum = false)
+		-> std::expected<shared_config, std::error_code>
+	{
+		if (!detail::is_shared_name(name))
+		{
+			return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+		}
+#if INI_MANAGER_HAS_MMAP
+		const int control_descriptor =
+			::shm_open(detail::shared_control_name(name).c_str(), O_RDONLY, 0);
+		if (control_descriptor < 0)
+		{
+			return std::unexpected(std::error_code(errno, std::system_category()));
+		}
+		std::shared_ptr<detail::shared_mapping> control;
+		{
+			const detail::descriptor_guard control_guard{control_descriptor};
+			struct stat info{};
+			if (::fstat(control_descriptor, &info) != 0)
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			if (static_cast<std::size_t>(info.st_size) < sizeof(detail::shared_control))
+			{
+				return std::unexpected(
+					std::make_error_code(std::errc::no_such_file_or_directory));
+			}
+			auto mapping = detail::shared_mapping::map(
+				control_descriptor, sizeof(detail::shared_control), false);
+			if (!mapping.has_value())
+			{
+				return std::unexpected(mapping.error());
+			}
+			control = std::move(*mapping);
+		}
+
+		// A publisher may unlink the generation just read; it then has a newer one
+		constexpr int attempts = 8;
+		for (int attempt = 0; attempt < attempts; ++attempt)
+		{
+			const auto generation = control->generation().load(std::memory_order_acquire);
+			if (generation == 0 || generation == detail::shared_unlinked_generation)
+			{
+				return std::unexpected(
+					std::make_error_code(std::errc::no_such_file_or_directory));
+			}
+			const auto segment = detail::shared_segment_name(name, generation);
+			const int descriptor = ::shm_open(segment.c_str(), O_RDONLY, 0);
+			if (descriptor < 0)
+			{
+				if (errno == ENOENT)
+				{
+					continue;
+				}
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			const detail::descriptor_guard guard{descriptor};
+			struct stat info{};
+			if (::fstat(descriptor, &info) != 0)
+			{
+				return std::unexpected(std::error_code(errno, std::system_category()));
+			}
+			auto data = detail::shared_mapping::map(
+				descriptor, static_cast<std::size_t>(info.st_size), false);
+			if (!data.has_value())
+			{
+				return std::unexpected(data.error());
+			}
+			const auto bytes = (*data)->bytes();
+			auto config =
+				binary_config::from_memory(std::move(*data), bytes, verify_checksum);
+			if (!config.has_value())
+			{
+				return std::unexpected(config.error());
+			}
+			return shared_config{std::move(*config), generation, std::move(control)};
+		}
+		return std::unexpected(
+			std::make_error_code(std::errc::resource_unavailable_try_again));
+#else
+		static_cast<void>(verify_checksum);
+		return std::unexpected(std::make_error_code(std::errc::not_supported));
+#endif
+	}
+
+	/**
+	 * @brief Gets the generation this object is attached to.
+	 * @return The generation number.
+	 */
+	auto generation() const noexcept -> std::uint64_t
+	{
+		return m_generation;
+	}
+
+	/**
+	 * @brief Checks whether the attached generation is still the published one.
+	 * @return `false` once a newer generation has been published or the
+	 * configuration has been unlinked.
+	 */
+	auto is_current() const noexcept -> bool
+	{
+#if INI_MANAGER_HAS_MMAP
+		return m_control->generation().load(std::memory_order_acquire) == m_generation;
+#else
+		return true;
+#endif
+	}
+
+  private:
+	std::uint64_t m_generation = 0;
+
+#if INI_MANAGER_HAS_MMAP
+	std::shared_ptr<const detail::shared_mapping> m_control;
+
+	shared_config(binary_config config, std::uint64_t generation,
+				  std::shared_ptr<detail::shared_mapping> control)
+		: binary_config(std::move(config)), m_generation(generation),
+		  m_control(std::move(control))
+	{
+	}
+#endif
+};
+
+} // namespace ini
+
+#endif // INI_MANAGER_SHARED_CONFIG_HPP
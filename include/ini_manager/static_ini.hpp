@@ -0,0 +1,460 @@
+/**
+ * @file static_ini.hpp
+ * @brief Compile-time parsing of embedded INI text into immutable lookup tables.
+ *
+ * Default configurations embedded as string literals can be parsed while compiling:
+ * @code
+ * constexpr auto defaults = ini::static_ini<R"(
+ * [server]
+ * port = 8080
+ * )">;
+ * static_assert(defaults.get_value_view(ini::section{"server"}, ini::key{"port"}) ==
+ *               "8080");
+ * @endcode
+ * The resulting table lives in read-only data and costs nothing at startup. Embedded
+ * text is parsed strictly, so a malformed line fails the build.
+ */
+
+#ifndef INI_MANAGER_STATIC_INI_HPP
+#define INI_MANAGER_STATIC_INI_HPP
+
+#include "ini_manager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace ini
+{
+
+/**
+ * @brief A string literal usable as a template argument.
+ * @tparam N The size of the literal, including the terminating null character.
+ */
+template <std::size_t N> struct fixed_string
+{
+	/**
+	 * @brief Constructs the fixed string from a string literal.
+	 * @param text The string literal.
+	 */
+	consteval fixed_string(const char (&text)[N]) noexcept // NOLINT(*-explicit-*)
+	{
+		std::copy_n(text, N, chars.begin());
+	}
+
+	/**
+	 * @brief Gets the contents without the terminating null character.
+	 * @return A string view over the characters.
+	 */
+	constexpr auto view() const noexcept -> std::string_view
+	{
+		return {chars.data(), N - 1};
+	}
+
+	/**
+	 * @brief The characters of the literal, including the terminating null character.
+	 */
+	std::array<char, N> chars{};
+};
+
+/**
+ * @brief A key-value pair of a compile-time INI table.
+ */
+struct static_entry
+{
+	/**
+	 * @brief The section containing the key.
+	 */
+	std::string_view section;
+	/**
+	 * @brief The key name.
+	 */
+	std::string_view key;
+	/**
+	 * @brief The value associated with the key.
+	 */
+	std::string_view value;
+};
+
+/**
+ * @brief A hash index slot of a compile-time INI table.
+ */
+struct static_index
+{
+	/**
+	 * @brief The hash of the section and key of the entry.
+	 */
+	std::uint64_t hash;
+	/**
+	 * @brief The position of the entry in the entry table.
+	 */
+	std::uint32_t entry;
+};
+
+/**
+ * @brief Read-only view of an immutable INI table, with constexpr lookups.
+ *
+ * Sections are sorted by name, entries by section and key, and the index by hash, so
+ * a lookup is a binary search over pre-computed hashes.
+ */
+class static_config : public detail::value_reader<static_config>
+{
+  public:
+	/**
+	 * @brief Constructs a view over pre-built tables, which must outlive it.
+	 * @param sections The section names, sorted.
+	 * @param entries The key-value pairs, sorted by section and key.
+	 * @param index The hash index over `entries`, sorted by hash.
+	 */
+	constexpr static_config(std::span<const std::string_view> sections,
+							std::span<const static_entry> entries,
+							std::span<const static_index> index) noexcept
+		: m_sections(sections), m_entries(entries), m_index(index)
+	{
+	}
+
+	/**
+	 * @brief Retrieves a string value for a given section and key without copying it.
+	 * @param section The section containing the key.
+	 * @param key The key whose value to retrieve.
+	 * @return A `std::optional` containing a view of the value,
+	 * or `std::nullopt` if the section or key does not exist.
+	 */
+	constexpr auto get_value_view(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		const auto hash = detail::hash_entry(section.value, key.value);
+		auto slot = std::ranges::lower_bound(m_index, hash, {}, &static_index::hash);
+		for (; slot != m_index.end() && slot->hash == hash; ++slot)
+		{
+			const auto &entry = m_entries[slot->entry];
+			if (entry.section == section.value && entry.key == key.value)
+			{
+				return entry.value;
+			}
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Checks whether a section exists.
+	 * @param section The section to look for.
+	 * @return `true` if the section exists, `false` otherwise.
+	 */
+	constexpr auto has_section(section section) const noexcept -> bool
+	{
+		return std::ranges::binary_search(m_sections, section.value);
+	}
+
+	/**
+	 * @brief Gets a list of all section names.
+	 * @return A `std::vector` containing the names of all sections, in alphabetical
+	 * order.
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		return {m_sections.begin(), m_sections.end()};
+	}
+
+	/**
+	 * @brief Gets a list of all key names within a specific section.
+	 * @param section The section whose keys are to be retrieved.
+	 * @return A `std::vector` containing the names of all keys in the specified section,
+	 * in alphabetical order. Returns an empty vector if the section does not exist.
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		const auto run = std::ranges::equal_range(m_entries, section.value, {},
+												  &static_entry::section);
+		std::vector<std::string> keys;
+		keys.reserve(run.size());
+		for (const auto &entry : run)
+		{
+			keys.emplace_back(entry.key);
+		}
+		return keys;
+	}
+
+	/**
+	 * @brief Gets the number of sections.
+	 * @return The section count.
+	 */
+	constexpr auto section_count() const noexcept -> std::size_t
+	{
+		return m_sections.size();
+	}
+
+	/**
+	 * @brief Gets the number of key-value pairs.
+	 * @return The entry count.
+	 */
+	constexpr auto size() const noexcept -> std::size_t
+	{
+		return m_entries.size();
+	}
+
+	/**
+	 * @brief Copies the table into a mutable ini_manager, e.g. to layer runtime
+	 * settings over embedded defaults.
+	 * @return An ini_manager holding the same sections and values.
+	 */
+	auto to_manager() const -> ini_manager
+	{
+		ini_manager manager;
+		for (const auto section_name : m_sections)
+		{
+			manager.set_section(std::string{section_name});
+		}
+		for (const auto &entry : m_entries)
+		{
+			manager.set_value(entry.section, entry.key, entry.value);
+		}
+		return manager;
+	}
+
+  private:
+	std::span<const std::string_view> m_sections;
+	std::span<const static_entry> m_entries;
+	std::span<const static_index> m_index;
+};
+
+/**
+ * @brief Fixed-size storage of a compile-time INI table.
+ * @tparam SectionCount The number of sections.
+ * @tparam EntryCount The number of key-value pairs.
+ */
+template <std::size_t SectionCount, std::size_t EntryCount>
+struct static_table : detail::value_reader<static_table<SectionCount, EntryCount>>
+{
+	/**
+	 * @brief The section names, sorted.
+	 */
+	std::array<std::string_view, SectionCount> sections{};
+	/**
+	 * @brief The key-value pairs, sorted by section and key.
+	 */
+	std::array<static_entry, EntryCount> entries{};
+	/**
+	 * @brief The hash index over `entries`, sorted by hash.
+	 */
+	std::array<static_index, EntryCount> index{};
+
+	/**
+	 * @brief Gets a lookup view over the table.
+	 * @return A `static_config` referring to this table.
+	 */
+	constexpr auto view() const noexcept -> static_config
+	{
+		return static_config{sections, entries, index};
+	}
+
+	/**
+	 * @copydoc static_config::get_value_view
+	 */
+	constexpr auto get_value_view(section section, key key) const noexcept
+		-> std::optional<std::string_view>
+	{
+		return view().get_value_view(section, key);
+	}
+
+	/**
+	 * @copydoc static_config::has_section
+	 */
+	constexpr auto has_section(section section) const noexcept -> bool
+	{
+		return view().has_section(section);
+	}
+
+	/**
+	 * @copydoc static_config::get_sections
+	 */
+	auto get_sections() const -> std::vector<std::string>
+	{
+		return view().get_sections();
+	}
+
+	/**
+	 * @copydoc static_config::get_keys
+	 */
+	auto get_keys(section section) const -> std::vector<std::string>
+	{
+		return view().get_keys(section);
+	}
+
+	/**
+	 * @copydoc static_config::section_count
+	 */
+	constexpr auto section_count() const noexcept -> std::size_t
+	{
+		return SectionCount;
+	}
+
+	/**
+	 * @copydoc static_config::size
+	 */
+	constexpr auto size() const noexcept -> std::size_t
+	{
+		return EntryCount;
+	}
+
+	/**
+	 * @copydoc static_config::to_manager
+	 */
+	auto to_manager() const -> ini_manager
+	{
+		return view().to_manager();
+	}
+};
+
+namespace detail
+{
+
+/**
+ * @brief Reached during constant evaluation when embedded INI text contains a line
+ * that is neither blank, a comment, a `[section]` header nor a `key = value` pair
+ * inside a section. Not being constexpr, it turns the line into a compile error.
+ */
+inline void malformed_static_ini_line() noexcept
+{
+}
+
+/**
+ * @brief Sections and entries parsed from embedded INI text, in table order.
+ */
+struct static_parse_result
+{
+	std::vector<std::string_view> sections;
+	std::vector<static_entry> entries;
+};
+
+/**
+ * @brief Parses embedded INI text with the same rules as `ini_manager`, except that
+ * lines the runtime parser would silently skip are rejected.
+ * @param text The INI text.
+ * @return The sorted sections and entries; a later duplicate key wins.
+ */
+constexpr auto parse_static_ini(std::string_view text) -> static_parse_result
+{
+	static_parse_result result;
+	std::optional<std::string_view> current_section;
+	while (!text.empty())
+	{
+		const auto line_end = std::min(text.find('\n'), text.size());
+		const auto line = trim(text.substr(0, line_end));
+		text.remove_prefix(std::min(line_end + 1, text.size()));
+
+		if (line.empty() || line.starts_with(';') || line.starts_with('#'))
+		{
+			continue;
+		}
+		if (line.starts_with('['))
+		{
+			if (!line.ends_with(']'))
+			{
+				malformed_static_ini_line();
+			}
+			current_section = trim(line.substr(1, line.size() - 2));
+			result.sections.push_back(*current_section);
+			continue;
+		}
+		const auto delimiter_pos = line.find('=');
+		if (delimiter_pos == std::string_view::npos || !current_section.has_value() ||
+			trim(line.substr(0, delimiter_pos)).empty())
+		{
+			malformed_static_ini_line();
+		}
+		result.entries.push_back({*current_section, trim(line.substr(0, delimiter_pos)),
+								  trim(line.substr(delimiter_pos + 1))});
+	}
+
+	std::ranges::sort(result.sections);
+	const auto duplicate_sections = std::ranges::unique(result.sections);
+	result.sections.erase(duplicate_sections.begin(), duplicate_sections.end());
+
+	// Keep the last occurrence of every key: order duplicates by position, then keep
+	// the final one of each run
+	std::vector<std::size_t> order(result.entries.size());
+	for (std::size_t index = 0; index < order.size(); ++index)
+	{
+		order[index] = index;
+	}
+	std::ranges::sort(order, {}, [&result](std::size_t index) {
+		const auto &entry = result.entries[index];
+		return std::tuple{entry.section, entry.key, index};
+	});
+	std::vector<static_entry> unique_entries;
+	for (std::size_t index = 0; index < order.size(); ++index)
+	{
+		const auto &entry = result.entries[order[index]];
+		if (index + 1 == order.size() ||
+			result.entries[order[index + 1]].section != entry.section ||
+			result.entries[order[index + 1]].key != entry.key)
+		{
+			unique_entries.push_back(entry);
+		}
+	}
+	result.entries = std::move(unique_entries);
+	return result;
+}
+
+/**
+ * @brief Table dimensions of embedded INI text.
+ */
+struct static_ini_size
+{
+	std::size_t sections;
+	std::size_t entries;
+};
+
+/**
+ * @brief Computes the table dimensions of embedded INI text.
+ * @param text The INI text.
+ * @return The number of sections and entries.
+ */
+consteval auto static_ini_size_of(std::string_view text) -> static_ini_size
+{
+	const auto result = parse_static_ini(text);
+	return {result.sections.size(), result.entries.size()};
+}
+
+/**
+ * @brief Builds the table for embedded INI text.
+ * @tparam Text The INI text.
+ * @return The filled table.
+ */
+template <fixed_string Text> consteval auto make_static_table()
+{
+	constexpr auto dimensions = static_ini_size_of(Text.view());
+	static_table<dimensions.sections, dimensions.entries> table;
+	const auto result = parse_static_ini(Text.view());
+	std::ranges::copy(result.sections, table.sections.begin());
+	std::ranges::copy(result.entries, table.entries.begin());
+	for (std::size_t index = 0; index < table.entries.size(); ++index)
+	{
+		table.index[index] = {
+			hash_entry(table.entries[index].section, table.entries[index].key),
+			static_cast<std::uint32_t>(index)};
+	}
+	std::ranges::sort(table.index, {}, &static_index::hash);
+	return table;
+}
+
+} // namespace detail
+
+/**
+ * @brief An INI string literal parsed at compile time into an immutable table.
+ * @tparam Text The INI text. Malformed lines fail the build.
+ */
+template <fixed_string Text>
+inline constexpr auto static_ini = detail::make_static_table<Text>();
+
+} // namespace ini
+
+#endif // INI_MANAGER_STATIC_INI_HPP
@@ -0,0 +1,389 @@
+/**
+ * @file tracing.hpp
+ * @brief Tracing hooks and USDT probes around loads, parses, writes and merges.
+ *
+ * A program observes the phases of the configuration layer by installing a hook:
+ * @code
+ * struct logger : ini::trace_hook
+ * {
+ *     void end(const ini::trace_span &span) noexcept override
+ *     {
+ *         std::clog << ini::to_string(span.event) << ' ' << span.bytes << " B in "
+ *                   << span.duration.count() << " ns\n";
+ *     }
+ * } hook;
+ * ini::set_trace_hook(&hook);
+ * @endcode
+ * Builds with `ini_manager_WITH_USDT` also place USDT probes, `<event>_start` and
+ * `<event>_done` of the `ini_manager` provider, for perf and bpftrace:
+ * @code
+ * bpftrace -e 'usdt:./app:ini_manager:load_done { @bytes = hist(arg0); }'
+ * @endcode
+ * The start probes pass the source path as pointer and length, the done probes the
+ * byte count and 1 on success; tracers time the phases from the probe timestamps.
+ * Each probe has an SDT semaphore that tracers raise while attached, so a phase is
+ * only observed while a hook is installed or a tracer watches one of its probes.
+ * With neither, each traced call costs one atomic load, plus a semaphore read per
+ * probe in USDT builds.
+ */
+
+#ifndef INI_MANAGER_TRACING_HPP
+#define INI_MANAGER_TRACING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// Defined by the build when ini_manager_WITH_USDT is enabled
+#if defined(INI_MANAGER_WITH_USDT)
+// Makes the probes record the address of their semaphore for tracers to raise
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#define INI_MANAGER_HAS_USDT 1
+#else
+#define INI_MANAGER_HAS_USDT 0
+#endif
+
+#if INI_MANAGER_HAS_USDT
+// sys/sdt.h refers to the semaphores by their unmangled names, so they live in the
+// global namespace
+#define INI_MANAGER_PROBE_SEMAPHORES(EVENT)                                            \
+	inline unsigned short ini_manager_##EVENT##_start_semaphore                        \
+		__attribute__((unused, section(".probes")));                                   \
+	inline unsigned short ini_manager_##EVENT##_done_semaphore                         \
+		__attribute__((unused, section(".probes")));
+INI_MANAGER_PROBE_SEMAPHORES(load)
+INI_MANAGER_PROBE_SEMAPHORES(parse)
+INI_MANAGER_PROBE_SEMAPHORES(write)
+INI_MANAGER_PROBE_SEMAPHORES(write_file)
+INI_MANAGER_PROBE_SEMAPHORES(merge)
+#undef INI_MANAGER_PROBE_SEMAPHORES
+#endif
+
+namespace ini
+{
+
+/**
+ * @brief The traced phases.
+ */
+enum class trace_event : std::uint8_t
+{
+	/**
+	 * @brief `from_file`, `from_stream`, `load_file` or `load_stream`.
+	 */
+	load,
+	/**
+	 * @brief Parsing one stream or file, decompression included.
+	 */
+	parse,
+	/**
+	 * @brief Writing the configuration to a stream.
+	 */
+	write,
+	/**
+	 * @brief `write_file`, which encloses a write.
+	 */
+	write_file,
+	/**
+	 * @brief `add_from_file` or `add_from_stream`.
+	 */
+	merge
+};
+
+/**
+ * @brief Returns the name of a traced phase, as used by the USDT probes.
+ * @param event The phase.
+ * @return The name, e.g. `"write_file"`.
+ */
+constexpr auto to_string(trace_event event) noexcept -> std::string_view
+{
+	switch (event)
+	{
+	case trace_event::load:
+		return "load";
+	case trace_event::parse:
+		return "parse";
+	case trace_event::write:
+		return "write";
+	case trace_event::write_file:
+		return "write_file";
+	case trace_event::merge:
+		return "merge";
+	}
+	return {};
+}
+
+/**
+ * @brief One completed phase.
+ */
+struct trace_span
+{
+	trace_event event;
+	/**
+	 * @brief The file path, or empty for streams.
+	 */
+	std::string_view source;
+	/**
+	 * @brief The INI text parsed or written, including that of nested phases.
+	 */
+	std::uint64_t bytes = 0;
+	std::chrono::nanoseconds duration{};
+	bool succeeded = false;
+};
+
+/**
+ * @brief Receives the traced phases of all threads.
+ *
+ * Calls arrive on the thread doing the work and may overlap; a phase that starts
+ * another (a load parsing its file) is reported inside it.
+ */
+class trace_hook
+{
+  public:
+	trace_hook() = default;
+	trace_hook(const trace_hook &) = default;
+	trace_hook(trace_hook &&) = default;
+	auto operator=(const trace_hook &) -> trace_hook & = default;
+	auto operator=(trace_hook &&) -> trace_hook & = default;
+	virtual ~trace_hook() = default;
+
+	/**
+	 * @brief Called when a phase starts.
+	 * @param event The phase.
+	 * @param source The file path, or empty for streams.
+	 */
+	virtual void begin([[maybe_unused]] trace_event event,
+					   [[maybe_unused]] std::string_view source) noexcept
+	{
+	}
+
+	/**
+	 * @brief Called when a phase ends.
+	 * @param span The phase, its byte count and duration.
+	 */
+	virtual void end(const trace_span &span) noexcept = 0;
+};
+
+namespace detail
+{
+
+inline std::atomic<trace_hook *> installed_trace_hook{nullptr};
+
+#if INI_MANAGER_HAS_USDT
+// sys/sdt.h needs the probe names as tokens, so each phase gets its own case
+#define INI_MANAGER_PROBE_CASES(CASE)                                                  \
+	switch (event)                                                                     \
+	{                                                                                  \
+	case trace_event::load:                                                            \
+		CASE(load)                                                                     \
+		break;                                                                         \
+	case trace_event::parse:                                                           \
+		CASE(parse)                                                                    \
+		break;                                                                         \
+	case trace_event::write:                                                           \
+		CASE(write)                                                                    \
+		break;                                                                         \
+	case trace_event::write_file:                                                      \
+		CASE(write_file)                                                               \
+		break;                                                                         \
+	case trace_event::merge:                                                           \
+		CASE(merge)                                                                    \
+		break;                                                                         \
+	}
+#define INI_MANAGER_PROBE_ATTACHED(EVENT)                                              \
+	return ini_manager_##EVENT##_start_semaphore != 0 ||                               \
+		   ini_manager_##EVENT##_done_semaphore != 0;
+#define INI_MANAGER_PROBE_START(EVENT)                                                 \
+	if (ini_manager_##EVENT##_start_semaphore != 0)                                    \
+	{                                                                                  \
+		DTRACE_PROBE2(ini_manager, EVENT##_start, data, size);                         \
+	}
+#define INI_MANAGER_PROBE_DONE(EVENT)                                                  \
+	if (ini_manager_##EVENT##_done_semaphore != 0)                                     \
+	{                                                                                  \
+		DTRACE_PROBE2(ini_manager, EVENT##_done, bytes, status);                       \
+	}
+#endif
+
+/**
+ * @brief Checks whether a tracer is attached to a probe of a phase.
+ */
+inline auto probed([[maybe_unused]] trace_event event) noexcept -> bool
+{
+#if INI_MANAGER_HAS_USDT
+	INI_MANAGER_PROBE_CASES(INI_MANAGER_PROBE_ATTACHED)
+#endif
+	return false;
+}
+
+inline void probe_start([[maybe_unused]] trace_event event,
+						[[maybe_unused]] std::string_view source) noexcept
+{
+#if INI_MANAGER_HAS_USDT
+	const auto *data = source.data();
+	const auto size = source.size();
+	INI_MANAGER_PROBE_CASES(INI_MANAGER_PROBE_START)
+#endif
+}
+
+inline void probe_done([[maybe_unused]] trace_event event,
+					   [[maybe_unused]] std::uint64_t bytes,
+					   [[maybe_unused]] bool succeeded) noexcept
+{
+#if INI_MANAGER_HAS_USDT
+	const int status = succeeded ? 1 : 0;
+	INI_MANAGER_PROBE_CASES(INI_MANAGER_PROBE_DONE)
+#endif
+}
+
+#if INI_MANAGER_HAS_USDT
+#undef INI_MANAGER_PROBE_CASES
+#undef INI_MANAGER_PROBE_ATTACHED
+#undef INI_MANAGER_PROBE_START
+#undef INI_MANAGER_PROBE_DONE
+#endif
+
+/**
+ * @brief Checks whether anything may observe the traced phases.
+ */
+inline auto tracing() noexcept -> bool
+{
+	return installed_trace_hook.load(std::memory_order_relaxed) != nullptr ||
+		   (INI_MANAGER_HAS_USDT != 0 &&
+			(probed(trace_event::load) || probed(trace_event::parse) ||
+			 probed(trace_event::write) || probed(trace_event::write_file) ||
+			 probed(trace_event::merge)));
+}
+
+/**
+ * @brief Traces one phase from its construction to its destruction.
+ *
+ * While a hook or a tracer observes it, the scope is the innermost of its thread, so
+ * that nested phases add their bytes to it; otherwise it only remembers that it is
+ * idle.
+ */
+class trace_scope
+{
+  public:
+	explicit trace_scope(trace_event event, std::string_view source = {}) noexcept
+		: m_span{event, source},
+		  m_hook(installed_trace_hook.load(std::memory_order_acquire)),
+		  m_active(m_hook != nullptr || probed(event))
+	{
+		if (!m_active)
+		{
+			return;
+		}
+		m_outer = std::exchange(innermost(), this);
+		probe_start(event, source);
+		if (m_hook != nullptr)
+		{
+			m_hook->begin(event, source);
+			m_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	trace_scope(const trace_scope &) = delete;
+	auto operator=(const trace_scope &) -> trace_scope & = delete;
+
+	~trace_scope()
+	{
+		if (!m_active)
+		{
+			return;
+		}
+		innermost() = m_outer;
+		if (m_outer != nullptr)
+		{
+			m_outer->add_bytes(m_span.bytes);
+		}
+		if (m_hook != nullptr)
+		{
+			m_span.duration = std::chrono::steady_clock::now() - m_start;
+			m_hook->end(m_span);
+		}
+		probe_done(m_span.event, m_span.bytes, m_span.succeeded);
+	}
+
+	void add_bytes(std::uint64_t bytes) noexcept
+	{
+		m_span.bytes += bytes;
+	}
+
+	void succeed() noexcept
+	{
+		m_span.succeeded = true;
+	}
+
+	/**
+	 * @brief Records the outcome of the phase.
+	 * @param result The `std::expected` the phase returns.
+	 * @return The result, unchanged.
+	 */
+	template <typename Result> auto complete(Result result) -> Result
+	{
+		m_span.succeeded = result.has_value();
+		return result;
+	}
+
+	/**
+	 * @brief Returns the innermost observed scope of the calling thread.
+	 */
+	static auto innermost() noexcept -> trace_scope *&
+	{
+		thread_local trace_scope *scope = nullptr;
+		return scope;
+	}
+
+  private:
+	trace_span m_span;
+	trace_hook *m_hook;
+	bool m_active;
+	trace_scope *m_outer = nullptr;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Adds bytes to the innermost observed phase of the calling thread.
+ * @param bytes The number of bytes parsed or written.
+ */
+inline void trace_bytes(std::uint64_t bytes) noexcept
+{
+	if (!tracing())
+	{
+		return;
+	}
+	if (auto *scope = trace_scope::innermost(); scope != nullptr)
+	{
+		scope->add_bytes(bytes);
+	}
+}
+
+} // namespace detail
+
+/**
+ * @brief Installs the hook that receives the traced phases of all threads.
+ *
+ * The hook must outlive its installation and any phase still reporting to it; a phase
+ * keeps reporting to the hook that was installed when it started.
+ * @param hook The hook, or `nullptr` to stop tracing.
+ * @return The previously installed hook, or `nullptr`.
+ */
+inline auto set_trace_hook(trace_hook *hook) noexcept -> trace_hook *
+{
+	return detail::installed_trace_hook.exchange(hook, std::memory_order_acq_rel);
+}
+
+/**
+ * @brief Returns the installed hook, or `nullptr`.
+ */
+inline auto get_trace_hook() noexcept -> trace_hook *
+{
+	return detail::installed_trace_hook.load(std::memory_order_acquire);
+}
+
+} // namespace ini
+
+#endif // INI_MANAGER_TRACING_HPP
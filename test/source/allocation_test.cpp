@@ -0,0 +1,133 @@
+#include "allocation_tracker.hpp"
+#include "ini_manager/ini_manager.hpp"
+
+#include <boost/ut.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Allocation budgets of the read path. Names and values are kept short enough for the
+// small string optimization, so any allocation counted comes from the library.
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+	using ini_test::count_allocations;
+
+	const suite allocation_tests = [] {
+		std::istringstream stream{"[server]\nhost = localhost\nport = 8080\n"
+								  "debug = true\n[client]\nretries = 3\n"};
+		const auto manager = *ini::ini_manager::from_stream(stream);
+		const ini::section server{"server"};
+		const ini::key host{"host"};
+		const ini::key absent{"absent"};
+		constexpr ini_test::allocation_counts none{};
+
+		describe("ini_test::count_allocations") = [] {
+			it("should count allocations and their sizes") = [] {
+				// Unlike new-expressions, direct calls cannot be optimized away
+				const auto counts = count_allocations([] {
+					::operator delete(::operator new(100));
+					::operator delete(::operator new(28));
+				});
+				expect(counts == ini_test::allocation_counts{2, 128});
+			};
+		};
+
+		// Results are checked outside the measured calls, which the test framework
+		// must not allocate in
+		describe("ini::ini_manager lookups") = [&] {
+			it("should not allocate in get_value_view") = [&] {
+				std::optional<std::string_view> hit;
+				std::optional<std::string_view> miss;
+				std::optional<std::string_view> no_section;
+				expect(count_allocations([&] {
+						   hit = manager.get_value_view(server, host);
+						   miss = manager.get_value_view(server, absent);
+						   no_section =
+							   manager.get_value_view(ini::section{"none"}, host);
+					   }) == none);
+				expect(hit == "localhost");
+				expect(!miss && !no_section);
+			};
+
+			it("should not allocate in get_value beyond the result") = [&] {
+				std::optional<std::string> hit;
+				std::optional<std::string> miss;
+				std::optional<std::string> subscript;
+				expect(count_allocations([&] {
+						   hit = manager.get_value(server, host);
+						   miss = manager.get_value(server, absent);
+						   subscript = manager["server"]["host"];
+					   }) == none);
+				expect(hit == "localhost" && subscript == "localhost");
+				expect(!miss);
+			};
+
+			it("should not allocate converting short values") = [&] {
+				std::optional<int> port;
+				std::optional<bool> debug;
+				std::optional<int> miss;
+				expect(count_allocations([&] {
+						   port = manager.get_value<int>(server, ini::key{"port"});
+						   debug = manager.get_value<bool>(server, ini::key{"debug"});
+						   miss = manager.get_value<int>(server, absent);
+					   }) == none);
+				expect(port == 8080 && debug == true);
+				expect(!miss);
+			};
+
+			it("should allocate once to copy a long value") = [] {
+				ini::ini_manager long_values;
+				const std::string value(200, 'v');
+				long_values.set_value("section", "key", value);
+				std::optional<std::string> copy;
+				const auto counts = count_allocations([&] {
+					copy =
+						long_values.get_value(ini::section{"section"}, ini::key{"key"});
+				});
+				expect(counts.allocations == 1U);
+				expect(copy == value);
+			};
+		};
+
+		describe("ini::ini_manager accessors") = [&] {
+			it("should not allocate in the views") = [&] {
+				std::size_t visited = 0;
+				expect(count_allocations([&] {
+						   for (const auto section : manager.sections())
+						   {
+							   visited += section.size();
+						   }
+						   for (const auto &entry : manager.entries(server))
+						   {
+							   visited += entry.second.size();
+						   }
+						   manager.for_each([&visited](std::string_view, std::string_view,
+													   std::string_view) { ++visited; });
+						   visited += manager.stats().keys;
+					   }) == none);
+				expect(visited > 0U);
+			};
+
+			it("should allocate one vector in get_sections and get_keys") = [&] {
+				std::vector<std::string> sections;
+				std::vector<std::string> keys;
+				expect(count_allocations([&] { sections = manager.get_sections(); })
+						   .allocations == 1U);
+				expect(count_allocations([&] { keys = manager.get_keys(server); })
+						   .allocations == 1U);
+				expect(sections.size() == 2U && keys.size() == 3U);
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
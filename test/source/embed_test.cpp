@@ -0,0 +1,46 @@
+#include "embedded_defaults.hpp"
+
+#include <boost/ut.hpp>
+
+#include <string>
+#include <vector>
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite embed_tests = [] {
+		describe("ini_manager_embed") = [] {
+			const auto &config = ini_test::embedded_defaults;
+
+			it("should expose the embedded values") = [&] {
+				expect(config.get_value(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+				expect(config.get_value<int>(ini::section{"server"},
+											 ini::key{"port"}) == 8080);
+				expect(config.get_value<bool>(ini::section{"flags"},
+											  ini::key{"verbose"}) == true);
+				expect(!config.get_value(ini::section{"server"}, ini::key{"missing"}));
+			};
+
+			it("should preserve characters that need escaping") = [&] {
+				expect(config.get_value_view(ini::section{"server"},
+											 ini::key{"greeting"}) ==
+					   R"(say "hi" \\ ok??=)");
+			};
+
+			it("should list sections and keys like ini_manager") = [&] {
+				expect(config.get_sections() ==
+					   std::vector<std::string>{"empty", "flags", "server"});
+				expect(config.get_keys(ini::section{"server"}) ==
+					   std::vector<std::string>{"greeting", "host", "port"});
+				expect(config.has_section(ini::section{"empty"}));
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
@@ -3,8 +3,15 @@
 #include <algorithm>
 #include <boost/ut.hpp>
 
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
 // NOLINTBEGIN(*-magic-numbers)
@@ -120,6 +127,22 @@ auto main() -> int
 					expect(manager.get_value(ini::section{"new_section"},
 											 ini::key{"new_key"}) == "new_value");
 				};
+
+				it("should support the usual string updates") = [] {
+					ini::ini_manager manager;
+					const auto before = manager.fingerprint();
+					manager["section"]["path"] = std::string{"/usr"};
+					manager["section"]["path"] += "/local";
+					manager["section"]["path"] += '/';
+					manager["section"]["path"].append("bin");
+					expect(manager["section"]["path"] == "/usr/local/bin");
+					manager["section"]["port"] = 8080;
+					expect(manager.get_value<int>(ini::section{"section"},
+												  ini::key{"port"}) == 8080);
+					const std::string &value = manager["section"]["path"];
+					expect(value == "/usr/local/bin");
+					expect(manager.fingerprint() != before);
+				};
 			};
 
 			describe("operator(const)") = [] {
@@ -614,6 +637,1140 @@ auto main() -> int
 				};
 			};
 		};
+
+		describe("ini::load_options::sidecar_cache") = [] {
+			const auto ini_path =
+				(std::filesystem::temp_directory_path() / "ini_manager_cache_test.ini")
+					.string();
+			const auto cache_path = ini_path + ".inicache";
+			const ini::load_options cached{.sidecar_cache = true};
+
+			it("should create the cache and load from it while it is valid") = [&] {
+				std::filesystem::remove(cache_path);
+				std::ofstream(ini_path) << "[section]\nkey = value\n[empty]\n";
+
+				auto first = ini::ini_manager::from_file(ini_path, cached);
+				expect(first.has_value());
+				expect(std::filesystem::exists(cache_path));
+				const auto cache_time = std::filesystem::last_write_time(cache_path);
+
+				auto second = ini::ini_manager::from_file(ini_path, cached);
+				expect(second.has_value());
+				expect(second->get_value(ini::section{"section"}, ini::key{"key"}) ==
+					   "value");
+				expect(second->get_sections() ==
+					   std::vector<std::string>{"empty", "section"});
+				// A cache hit must not rewrite the cache
+				expect(std::filesystem::last_write_time(cache_path) == cache_time);
+			};
+
+			it("should refresh the cache when the source changes") = [&] {
+				std::ofstream(ini_path) << "[section]\nkey = value\n";
+				expect(ini::ini_manager::from_file(ini_path, cached).has_value());
+				const auto source_time = std::filesystem::last_write_time(ini_path);
+
+				// Same size and modification time, different content
+				std::ofstream(ini_path) << "[section]\nkey = other\n";
+				std::filesystem::last_write_time(ini_path, source_time);
+
+				ini::ini_manager manager;
+				expect(manager.load_file(ini_path, cached).has_value());
+				expect(manager.get_value(ini::section{"section"}, ini::key{"key"}) ==
+					   "other");
+				auto reloaded = ini::ini_manager::from_file(ini_path, cached);
+				expect(reloaded->get_value(ini::section{"section"}, ini::key{"key"}) ==
+					   "other");
+			};
+
+			it("should fall back to parsing when the cache is damaged") = [&] {
+				std::ofstream(ini_path) << "[section]\nkey = value\n";
+				std::ofstream(cache_path) << "garbage";
+				auto result = ini::ini_manager::from_file(ini_path, cached);
+				expect(result.has_value());
+				expect(result->get_value(ini::section{"section"}, ini::key{"key"}) ==
+					   "value");
+				expect(std::filesystem::file_size(cache_path) > 7U);
+			};
+
+			it("should merge cached data with add_from_file") = [&] {
+				std::ofstream(ini_path) << "[section]\nkey = value\n";
+				expect(ini::ini_manager::from_file(ini_path, cached).has_value());
+				ini::ini_manager manager;
+				manager.set_value("section", "existing", "kept");
+				manager.set_value("section", "key", "overwritten");
+				expect(manager.add_from_file(ini_path, cached).has_value());
+				expect(manager.get_value(ini::section{"section"},
+										 ini::key{"existing"}) == "kept");
+				expect(manager.get_value(ini::section{"section"}, ini::key{"key"}) ==
+					   "value");
+				std::filesystem::remove(ini_path);
+				std::filesystem::remove(cache_path);
+			};
+
+			it("should load into the storage shared by copies") = [&] {
+				std::filesystem::remove(cache_path);
+				std::ofstream(ini_path) << "[section]\nkey = value\n";
+				// Once without a cache and once from the cache just written
+				for (int round = 0; round < 2; ++round)
+				{
+					ini::ini_manager manager;
+					const auto copy = manager;
+					expect(manager.add_from_file(ini_path, cached).has_value());
+					expect(copy.get_value(ini::section{"section"}, ini::key{"key"}) ==
+						   "value");
+				}
+				expect(std::filesystem::exists(cache_path));
+				std::filesystem::remove(ini_path);
+				std::filesystem::remove(cache_path);
+			};
+
+			it("should report missing source files") = [&] {
+				expect(!ini::ini_manager::from_file(ini_path, cached).has_value());
+			};
+		};
+
+		describe("ini::load_options::includes") = [] {
+			const auto directory =
+				std::filesystem::temp_directory_path() / "ini_manager_include_test";
+			std::filesystem::create_directories(directory / "fragments");
+			const auto path = [&directory](const char *name) {
+				return (directory / name).string();
+			};
+			std::ofstream(path("fragments/common.ini"))
+				<< "[common]\nshared = yes\n";
+			std::ofstream(path("fragments/logging.ini"))
+				<< "level = debug\n@include common.ini\n";
+			std::ofstream(path("main.ini"))
+				<< "!include fragments/common.ini\n[app]\nname = demo\n"
+				   "@include \"fragments/logging.ini\"\nafter = app\n";
+			const ini::load_options including{.includes = true};
+
+			it("should parse included files in place of the directives") = [&] {
+				auto manager = ini::ini_manager::from_file(path("main.ini"), including);
+				expect(manager.has_value());
+				expect(manager->get_value(ini::section{"common"}, ini::key{"shared"}) ==
+					   "yes");
+				// An included file starts in the section of the directive, and the
+				// including file continues in that section
+				expect(manager->get_value(ini::section{"app"}, ini::key{"level"}) ==
+					   "debug");
+				expect(manager->get_value(ini::section{"app"}, ini::key{"after"}) ==
+					   "app");
+				expect(!manager->get_value(ini::section{"common"}, ini::key{"after"}));
+			};
+
+			it("should ignore directives by default") = [&] {
+				auto manager = ini::ini_manager::from_file(path("main.ini"));
+				expect(manager.has_value());
+				expect(manager->get_sections() == std::vector<std::string>{"app"});
+
+				std::istringstream stream{std::format("!include {}\n",
+													  path("fragments/common.ini"))};
+				ini::ini_manager streamed;
+				stream >> streamed;
+				expect(streamed.get_sections().empty());
+			};
+
+			it("should keep keys that merely start like a directive") = [&] {
+				const std::string text{"[paths]\n@include_dir = /usr/include\n"
+									   "!include_me = 1\n!include = 2\nother = 3\n"};
+				for (const bool includes : {false, true})
+				{
+					std::istringstream stream{text};
+					auto manager =
+						ini::ini_manager::from_stream(stream, {.includes = includes});
+					expect(manager.has_value());
+					const ini::section paths{"paths"};
+					expect(manager->get_value(paths, ini::key{"@include_dir"}) ==
+						   "/usr/include");
+					expect(manager->get_value(paths, ini::key{"!include_me"}) == "1");
+					expect(manager->get_value(paths, ini::key{"!include"}) == "2");
+					expect(manager->get_value(paths, ini::key{"other"}) == "3");
+				}
+			};
+
+			it("should resolve stream includes against the working directory") = [&] {
+				std::istringstream stream{std::format("!include {}\n",
+													  path("fragments/common.ini"))};
+				auto manager = ini::ini_manager::from_stream(stream, including);
+				expect(manager.has_value());
+				expect(manager->get_value(ini::section{"common"}, ini::key{"shared"}) ==
+					   "yes");
+			};
+
+			it("should report include cycles and missing files") = [&] {
+				std::ofstream(path("first.ini")) << "[a]\n!include second.ini\n";
+				std::ofstream(path("second.ini")) << "[b]\n!include first.ini\n";
+				auto cycle = ini::ini_manager::from_file(path("first.ini"), including);
+				expect(!cycle.has_value() &&
+					   cycle.error() == std::errc::too_many_symbolic_link_levels);
+
+				std::ofstream(path("missing.ini")) << "!include nowhere.ini\n";
+				expect(!ini::ini_manager::from_file(path("missing.ini"), including)
+							.has_value());
+			};
+
+			it("should reuse a shared include cache until a fragment changes") = [&] {
+				const auto cache = std::make_shared<ini::include_cache>();
+				const ini::load_options options{.includes = true,
+												.shared_include_cache = cache};
+				expect(
+					ini::ini_manager::from_file(path("main.ini"), options).has_value());
+				expect(cache->size() == 2U);
+
+				std::ofstream(path("fragments/common.ini"))
+					<< "[common]\nshared = no, changed\n";
+				auto manager = ini::ini_manager::from_file(path("main.ini"), options);
+				expect(manager.has_value());
+				expect(manager->get_value(ini::section{"common"}, ini::key{"shared"}) ==
+					   "no, changed");
+				expect(cache->size() == 2U);
+			};
+
+			it("should not keep a sidecar cache for files with directives") = [&] {
+				const ini::load_options cached{.sidecar_cache = true, .includes = true};
+				expect(ini::ini_manager::from_file(path("main.ini"), cached).has_value());
+				expect(!std::filesystem::exists(path("main.ini.inicache")));
+			};
+
+			std::filesystem::remove_all(directory);
+		};
+
+		describe("ini::load_options::inheritance") = [] {
+			const ini::load_options inheriting{.inheritance = true};
+
+			it("should fall through the chain of parents") = [&inheriting] {
+				std::istringstream stream{"[base]\nhost = localhost\nport = 80\n"
+										  "[staging : base]\nport = 8080\n"
+										  "[prod : staging]\nhost = example.com\n"};
+				const auto manager = ini::ini_manager::from_stream(stream, inheriting);
+				expect(manager.has_value());
+				const ini::section prod{"prod"};
+				expect(manager->get_value<int>(prod, ini::key{"port"}) == 8080);
+				expect(manager->get_value(prod, ini::key{"host"}) == "example.com");
+				expect(manager->get_value_view(ini::section{"staging"},
+											   ini::key{"host"}) == "localhost");
+				expect((*manager)["prod"]["port"] == "8080");
+				expect(!manager->get_value(prod, ini::key{"missing"}));
+				expect(manager->get_keys(prod) == std::vector<std::string>{"host"});
+				expect(manager->get_parent(prod) == "staging");
+				expect(!manager->get_parent(ini::section{"base"}));
+				expect(manager->resolution_chain(prod) ==
+					   std::vector<std::string_view>{"prod", "staging", "base"});
+			};
+
+			it("should keep the whole header as the name when disabled") = [] {
+				std::istringstream stream{"[prod : base]\nport = 1\n"};
+				const auto manager = ini::ini_manager::from_stream(stream);
+				expect(manager->get_sections() ==
+					   std::vector<std::string>{"prod : base"});
+			};
+
+			it("should follow structural changes") = [] {
+				ini::ini_manager manager;
+				expect(manager.set_parent("child", "parent").has_value());
+				const ini::section child{"child"};
+				const ini::key key{"key"};
+				expect(!manager.get_value(child, key));
+				expect(manager.resolution_chain(child) ==
+					   std::vector<std::string_view>{"child"});
+
+				manager.set_value("parent", "key", "inherited");
+				expect(manager.get_value(child, key) == "inherited");
+				manager.set_value("child", "key", "own");
+				expect(manager.get_value(child, key) == "own");
+				manager.remove_value(child, key);
+
+				manager.set_value("other", "key", "other");
+				expect(manager.set_parent("child", "other").has_value());
+				expect(manager.get_value(child, key) == "other");
+				manager.remove_section(ini::section{"other"});
+				expect(!manager.get_value(child, key));
+				expect(manager.set_parent("child", "").has_value());
+				expect(!manager.get_parent(child));
+
+				// Changes further up reach every section below
+				const ini::key deep{"deep"};
+				manager.set_value("root", "deep", "yes");
+				expect(manager.set_parent("middle", "root").has_value());
+				expect(manager.set_parent("child", "middle").has_value());
+				expect(manager.get_value(child, deep) == "yes");
+				manager.remove_section(ini::section{"root"});
+				expect(!manager.get_value(child, deep));
+				expect(manager.resolution_chain(child) ==
+					   std::vector<std::string_view>{"child", "middle"});
+				manager.set_value("root", "deep", "again");
+				expect(manager.get_value(child, deep) == "again");
+				expect(manager.resolution_chain(child) ==
+					   std::vector<std::string_view>{"child", "middle", "root"});
+			};
+
+			it("should reject cycles") = [&inheriting] {
+				ini::ini_manager manager;
+				expect(manager.set_parent("a", "b").has_value());
+				expect(manager.set_parent("b", "c").has_value());
+				expect(manager.set_parent("c", "a").error() ==
+					   std::errc::too_many_symbolic_link_levels);
+				expect(manager.set_parent("a", "a").error() ==
+					   std::errc::too_many_symbolic_link_levels);
+
+				std::istringstream stream{"[a : b]\n[b : a]\n"};
+				expect(ini::ini_manager::from_stream(stream, inheriting).error() ==
+					   std::errc::too_many_symbolic_link_levels);
+			};
+
+			it("should write parents back to the headers") = [&inheriting] {
+				std::istringstream stream{"[base]\nx = 1\n[prod: base ]\ny = 2\n"};
+				const auto manager = ini::ini_manager::from_stream(stream, inheriting);
+				std::ostringstream written;
+				written << *manager;
+				expect(written.str() == "[base]\nx = 1\n\n[prod : base]\ny = 2\n\n");
+
+				std::istringstream reread{written.str()};
+				const auto copy = ini::ini_manager::from_stream(reread, inheriting);
+				expect(copy->get_value(ini::section{"prod"}, ini::key{"x"}) == "1");
+				expect(*copy == *manager);
+
+				// Without inheritance the header reads back as one section name
+				std::istringstream plain{written.str()};
+				expect(*ini::ini_manager::from_stream(plain) != *manager);
+			};
+		};
+
+		describe("ini::ini_manager::get_interpolated") = [] {
+			it("should expand references to keys and the environment") = [] {
+				const std::string path = std::getenv("PATH");
+				std::istringstream stream{"[paths]\nroot = ${ENV:PATH}\n"
+										  "data = ${root}/data\n"
+										  "[db]\nfile = ${paths:data}/db.sqlite\n"
+										  "price = $$5 and $x\n"};
+				const auto manager = ini::ini_manager::from_stream(stream);
+				expect(manager->get_interpolated(ini::section{"db"}, ini::key{"file"}) ==
+					   path + "/data/db.sqlite");
+				expect(manager->get_interpolated(ini::section{"db"}, ini::key{"price"}) ==
+					   "$5 and $x");
+				expect(manager->get_value(ini::section{"db"}, ini::key{"file"}) ==
+					   "${paths:data}/db.sqlite");
+			};
+
+			it("should invalidate exactly the results built from a change") = [] {
+				std::istringstream stream{"[a]\nx = 1\ny = ${x}${x}\nz = ${y}!\n"
+										  "[b]\nw = ${a:x}\nv = constant\n"};
+				auto manager = ini::ini_manager::from_stream(stream);
+				const ini::section a{"a"};
+				const ini::section b{"b"};
+				const ini::key w{"w"};
+				expect(manager->get_interpolated(a, ini::key{"z"}) == "11!");
+				expect(manager->get_interpolated(b, w) == "1");
+
+				manager->set_value("a", "x", 2);
+				expect(manager->get_interpolated(a, ini::key{"z"}) == "22!");
+				expect(manager->get_interpolated(b, w) == "2");
+
+				(*manager)["a"]["y"] = "${x}";
+				expect(manager->get_interpolated(a, ini::key{"z"}) == "2!");
+
+				manager->remove_section(ini::section{"a"});
+				expect(manager->get_interpolated(b, w).error() ==
+					   std::errc::no_such_file_or_directory);
+				expect(manager->get_interpolated(b, ini::key{"v"}) == "constant");
+
+				std::istringstream reload{"[a]\nx = 3\n[b]\nw = ${a:x}\n"};
+				expect(manager->load_stream(reload).has_value());
+				expect(manager->get_interpolated(b, w) == "3");
+			};
+
+			it("should report cycles and malformed references") = [] {
+				std::istringstream stream{"[a]\nx = ${y}\ny = ${b:z}\n[b]\nz = ${a:x}\n"
+										  "self = ${self}\nopen = ${a:x\n"};
+				const auto manager = ini::ini_manager::from_stream(stream);
+				expect(manager->get_interpolated(ini::section{"a"}, ini::key{"x"})
+						   .error() ==
+					   std::errc::too_many_symbolic_link_levels);
+				expect(manager->get_interpolated(ini::section{"b"}, ini::key{"self"})
+						   .error() == std::errc::too_many_symbolic_link_levels);
+				expect(manager->get_interpolated(ini::section{"b"}, ini::key{"open"})
+						   .error() == std::errc::invalid_argument);
+				expect(manager->get_interpolated(ini::section{"b"}, ini::key{"none"})
+						   .error() == std::errc::no_such_file_or_directory);
+			};
+		};
+
+		describe("ini::glob") = [] {
+			const auto matches = [](std::string_view pattern, std::string_view name) {
+				return ini::glob::compile(pattern)->matches(name);
+			};
+
+			it("should match wildcards, sets and escapes") = [&matches] {
+				expect(matches("tenant-*", "tenant-42"));
+				expect(matches("tenant-*", "tenant-"));
+				expect(!matches("tenant-*", "tenants"));
+				expect(matches("*.timeout_ms", "db.read.timeout_ms"));
+				expect(!matches("*.timeout_ms", "db.timeout_ms.max"));
+				expect(matches("a*b*c", "aXbYbZc"));
+				expect(!matches("a*b*c", "aXbYbZ"));
+				expect(matches("node-??", "node-07"));
+				expect(!matches("node-??", "node-7"));
+				expect(matches("node-[0-9][!a-z]", "node-1X"));
+				expect(!matches("node-[0-9][!a-z]", "node-1x"));
+				expect(matches("[]x]", "]"));
+				expect(matches("a\\*", "a*"));
+				expect(!matches("a\\*", "ab"));
+				expect(matches("**", ""));
+				expect(!matches("", "a"));
+			};
+
+			it("should expose the literal prefix") = [] {
+				expect(ini::glob::compile("tenant-*.x")->literal_prefix() == "tenant-");
+				expect(ini::glob::compile("a\\*b*")->literal_prefix() == "a*b");
+				expect(ini::glob::compile("*x")->literal_prefix().empty());
+			};
+
+			it("should reject malformed patterns") = [] {
+				for (const auto *pattern : {"[abc", "abc\\"})
+				{
+					expect(ini::glob::compile(pattern).error() ==
+						   std::errc::invalid_argument);
+				}
+			};
+
+			it("should query sections and keys") = [] {
+				std::istringstream stream{"[tenant-1]\ndb.timeout_ms = 5\nname = a\n"
+										  "[tenant-2]\ncache.timeout_ms = 7\n"
+										  "[tenants]\nx.timeout_ms = 9\n[other]\n"};
+				const auto manager = ini::ini_manager::from_stream(stream);
+				const auto tenants = *ini::glob::compile("tenant-*");
+				const auto timeouts = *ini::glob::compile("*.timeout_ms");
+
+				std::vector<std::string_view> names;
+				for (const std::string_view name : manager->sections_matching(tenants))
+				{
+					names.push_back(name);
+				}
+				expect(names == std::vector<std::string_view>{"tenant-1", "tenant-2"});
+
+				names.clear();
+				for (const std::string_view name :
+					 manager->keys_matching(ini::section{"tenant-1"}, timeouts))
+				{
+					names.push_back(name);
+				}
+				expect(names == std::vector<std::string_view>{"db.timeout_ms"});
+				expect(manager->keys_matching(ini::section{"none"}, timeouts).empty());
+
+				std::string visited;
+				const auto visit = [&visited](std::string_view section,
+											  std::string_view key,
+											  std::string_view value) {
+					visited += std::format("{}:{}={};", section, key, value);
+				};
+				manager->for_each_match(tenants, timeouts, visit);
+				expect(visited ==
+					   "tenant-1:db.timeout_ms=5;tenant-2:cache.timeout_ms=7;");
+			};
+		};
+
+		describe("ini::ini_manager reverse value index") = [] {
+			using location = std::pair<std::string_view, std::string_view>;
+
+			for (const bool value_index : {false, true})
+			{
+				given(value_index ? "the index" : "no index") = [value_index] {
+					std::istringstream stream{"[db]\nprimary = host-a\nreplica = host-b\n"
+											  "[cache]\nhost = host-a\nport = 6379\n"};
+					auto manager = ini::ini_manager::from_stream(
+						stream, {.value_index = value_index});
+					expect(manager->has_value_index() == value_index);
+
+					it("should find the keys holding a value") = [&] {
+						expect(manager->find_by_value("host-a") ==
+							   std::vector<location>{{"cache", "host"},
+													 {"db", "primary"}});
+						expect(manager->find_by_value("host-c").empty());
+					};
+
+					it("should follow every kind of change") = [&] {
+						manager->set_value("db", "primary", "host-c");
+						(*manager)["db"]["replica"] = "host-a";
+						manager->set_value("web", "upstream", "host-c");
+						expect(manager->find_by_value("host-a") ==
+							   std::vector<location>{{"cache", "host"},
+													 {"db", "replica"}});
+						expect(manager->find_by_value("host-b").empty());
+
+						manager->remove_value(ini::section{"cache"}, ini::key{"host"});
+						manager->remove_section(ini::section{"web"});
+						expect(manager->find_by_value("host-a") ==
+							   std::vector<location>{{"db", "replica"}});
+						expect(manager->find_by_value("host-c") ==
+							   std::vector<location>{{"db", "primary"}});
+
+						std::istringstream more{"[cache]\nhost = host-a\n"};
+						expect(manager->add_from_stream(more).has_value());
+						expect(manager->find_by_value("host-a").size() == 2U);
+					};
+				};
+			}
+
+			it("should build the index from existing data") = [] {
+				ini::ini_manager manager;
+				manager.set_value("a", "x", "1");
+				manager.set_value("b", "y", "1");
+				manager.enable_value_index();
+				expect(manager.find_by_value("1") ==
+					   std::vector<location>{{"a", "x"}, {"b", "y"}});
+			};
+		};
+
+		describe("ini::ini_manager key filter") = [] {
+			it("should never reject a present key") = [] {
+				ini::ini_manager manager;
+				manager.set_value("seed", "key", "value");
+				manager.enable_key_filter();
+				expect(manager.has_key_filter());
+				for (int index = 0; index < 2000; ++index)
+				{
+					manager.set_value(std::format("section{}", index % 37),
+									  std::format("key{}", index), index);
+				}
+				for (int index = 0; index < 2000; ++index)
+				{
+					const auto section = std::format("section{}", index % 37);
+					const auto key = std::format("key{}", index);
+					expect(manager.get_value<int>(ini::section{section}, ini::key{key}) ==
+						   index);
+				}
+				expect(manager.get_value_view(ini::section{"seed"}, ini::key{"key"}) ==
+					   "value");
+				expect(!manager.get_value(ini::section{"section1"}, ini::key{"absent"}));
+			};
+
+			it("should follow removals and reloads") = [] {
+				std::istringstream stream{"[a]\nx = 1\ny = 2\n[b]\nz = 3\n"};
+				auto manager =
+					ini::ini_manager::from_stream(stream, {.key_filter = true});
+				expect(manager->has_key_filter());
+				for (int round = 0; round < 100; ++round)
+				{
+					manager->remove_value(ini::section{"a"}, ini::key{"x"});
+					expect(!manager->get_value(ini::section{"a"}, ini::key{"x"}));
+					manager->set_value("a", "x", round);
+					expect(manager->get_value<int>(ini::section{"a"}, ini::key{"x"}) ==
+						   round);
+				}
+				manager->remove_section(ini::section{"b"});
+				expect(!manager->get_value(ini::section{"b"}, ini::key{"z"}));
+				manager->set_value("b", "z", "4");
+				expect(manager->get_value(ini::section{"b"}, ini::key{"z"}) == "4");
+
+				std::istringstream reloaded{"[c]\nw = 5\n"};
+				expect(manager->load_stream(reloaded).has_value());
+				expect(manager->has_key_filter());
+				expect(manager->get_value(ini::section{"c"}, ini::key{"w"}) == "5");
+				expect(!manager->get_value(ini::section{"a"}, ini::key{"y"}));
+			};
+
+			it("should see through parents") = [] {
+				ini::ini_manager manager;
+				manager.enable_key_filter();
+				manager.set_value("base", "key", "inherited");
+				expect(manager.set_parent("child", "base").has_value());
+				expect(manager.get_value(ini::section{"child"}, ini::key{"key"}) ==
+					   "inherited");
+
+				manager.set_value("root", "deep", "yes");
+				manager.set_value("child", "own", "child");
+				manager.set_value("base", "own", "base");
+				expect(manager.set_parent("base", "root").has_value());
+				expect(manager.get_value(ini::section{"child"}, ini::key{"deep"}) ==
+					   "yes");
+				expect(manager.get_value(ini::section{"child"}, ini::key{"own"}) ==
+					   "child");
+				expect(!manager.get_value(ini::section{"child"}, ini::key{"absent"}));
+				expect(!manager.get_value(ini::section{"root"}, ini::key{"key"}));
+			};
+		};
+
+		describe("ini::ini_manager zero-copy iteration") = [] {
+			std::istringstream stream{"[b]\ny = 2\nx = 1\n[a]\nk = v\n[empty]\n"};
+			auto manager = ini::ini_manager::from_stream(stream);
+
+			it("should list sections and entries as views") = [&] {
+				std::vector<std::string_view> sections;
+				for (const std::string_view section : manager->sections())
+				{
+					sections.push_back(section);
+				}
+				expect(sections == std::vector<std::string_view>{"a", "b", "empty"});
+
+				using entry = std::pair<std::string_view, std::string_view>;
+				std::vector<entry> entries;
+				for (const auto &pair : manager->entries(ini::section{"b"}))
+				{
+					entries.push_back(pair);
+				}
+				expect(entries == std::vector<entry>{{"x", "1"}, {"y", "2"}});
+				expect(manager->entries(ini::section{"empty"}).empty());
+				expect(manager->entries(ini::section{"missing"}).empty());
+			};
+
+			it("should visit every entry in order") = [&] {
+				std::string visited;
+				manager->for_each(
+					[&visited](std::string_view section, std::string_view key,
+							   std::string_view value) {
+						visited += std::format("{}.{}={};", section, key, value);
+					});
+				expect(visited == "a.k=v;b.x=1;b.y=2;");
+			};
+
+			it("should view values in place") = [&] {
+				expect(manager->get_value_view(ini::section{"a"}, ini::key{"k"}) == "v");
+				manager->set_value("a", "k", "w");
+				expect(manager->get_value_view(ini::section{"a"}, ini::key{"k"}) == "w");
+				expect(!manager->get_value_view(ini::section{"a"}, ini::key{"none"}));
+				expect(!manager->get_value_view(ini::section{"none"}, ini::key{"k"}));
+			};
+		};
+
+		describe("ini::ini_manager section tree") = [] {
+			const auto load = [](bool section_tree) {
+				std::istringstream stream{"[service]\ntimeout = 30\nretries = 3\n"
+										  "[service.cache]\ntimeout = 5\n"
+										  "[service.cache.l1]\nsize = 64\n"
+										  "[service.cache-x]\n[service.db.primary]\n"
+										  "[services]\n"};
+				return ini::ini_manager::from_stream(stream,
+													 {.section_tree = section_tree});
+			};
+
+			for (const bool section_tree : {false, true})
+			{
+				given(section_tree ? "the index" : "no index") = [&load, section_tree] {
+					auto manager = load(section_tree);
+					expect(manager->has_section_tree() == section_tree);
+
+					it("should list subsections in tree order") = [&] {
+						expect(manager->subsections(ini::section{"service"}) ==
+							   std::vector<std::string_view>{
+								   "service.cache", "service.cache.l1", "service.cache-x",
+								   "service.db.primary"});
+						expect(manager->subsections(ini::section{"service.db"}) ==
+							   std::vector<std::string_view>{"service.db.primary"});
+						expect(manager->subsections(ini::section{"missing"}).empty());
+					};
+
+					it("should find the nearest ancestor with a key") = [&] {
+						const ini::section l1{"service.cache.l1"};
+						expect(manager->nearest_section_with_key(l1, ini::key{"size"}) ==
+							   "service.cache.l1");
+						expect(manager->nearest_section_with_key(
+								   l1, ini::key{"timeout"}) == "service.cache");
+						expect(manager->get_inherited_value(l1, ini::key{"retries"}) ==
+							   "3");
+						expect(manager->get_inherited_value(
+								   ini::section{"service.db.primary.x"},
+								   ini::key{"timeout"}) == "30");
+						expect(!manager->nearest_section_with_key(l1, ini::key{"none"}));
+					};
+
+					it("should follow added and removed sections") = [&] {
+						manager->set_value("service.cache.l2", "size", 128);
+						manager->remove_section(ini::section{"service.cache.l1"});
+						manager->remove_section(ini::section{"service.db.primary"});
+						expect(manager->subsections(ini::section{"service"}) ==
+							   std::vector<std::string_view>{"service.cache",
+															 "service.cache.l2",
+															 "service.cache-x"});
+						expect(manager->get_inherited_value(
+								   ini::section{"service.cache.l2"},
+								   ini::key{"timeout"}) == "5");
+					};
+				};
+			}
+
+			it("should keep the index across reloads") = [] {
+				ini::ini_manager manager;
+				manager.enable_section_tree();
+				std::istringstream stream{"[a]\n[a.b]\n"};
+				expect(manager.load_stream(stream).has_value());
+				expect(manager.has_section_tree());
+				expect(manager.subsections(ini::section{"a"}) ==
+					   std::vector<std::string_view>{"a.b"});
+			};
+		};
+
+		describe("ini::ini_manager prefix and range queries") = [] {
+			const auto to_vector = [](auto &&names) {
+				std::vector<std::string> result;
+				for (const std::string_view name : names)
+				{
+					result.emplace_back(name);
+				}
+				return result;
+			};
+
+			std::istringstream stream{"[db]\ndb.primary.host = a\ndb.primary.port = 1\n"
+									  "db.primaryx = b\ndb.replica.host = c\nd = e\n"
+									  "[service]\n[service.cache]\n[service.cache.l1]\n"
+									  "[services]\n[\xFF]\n"};
+			const auto manager = ini::ini_manager::from_stream(stream);
+
+			it("should list the keys with a prefix") = [&] {
+				expect(to_vector(manager->keys_with_prefix(ini::section{"db"},
+														   "db.primary.")) ==
+					   std::vector<std::string>{"db.primary.host", "db.primary.port"});
+				const ini::section database{"db"};
+				expect(to_vector(manager->keys_with_prefix(database, "db.")).size() ==
+					   4U);
+				expect(to_vector(manager->keys_with_prefix(database, "")).size() == 5U);
+				expect(manager->keys_with_prefix(ini::section{"db"}, "x").empty());
+				expect(manager->keys_with_prefix(ini::section{"missing"}, "db").empty());
+			};
+
+			it("should list the sections with a prefix") = [&] {
+				expect(to_vector(manager->sections_with_prefix("service.")) ==
+					   std::vector<std::string>{"service.cache", "service.cache.l1"});
+				expect(to_vector(manager->sections_with_prefix("service")).size() == 4U);
+				expect(to_vector(manager->sections_with_prefix("\xFF")) ==
+					   std::vector<std::string>{"\xFF"});
+			};
+
+			it("should list half-open ranges") = [&] {
+				expect(to_vector(manager->keys_in_range(
+						   ini::section{"db"}, "db.primary.port", "db.replica.host")) ==
+					   std::vector<std::string>{"db.primary.port", "db.primaryx"});
+				expect(manager->keys_in_range(ini::section{"db"}, "z", "a").empty());
+				expect(to_vector(manager->sections_in_range("db", "service.cache")) ==
+					   std::vector<std::string>{"db", "service"});
+				expect(manager->sections_in_range("service", "service").empty());
+			};
+		};
+
+		describe("ini::ini_manager::stats") = [] {
+			it("should count sections, keys and bytes") = [] {
+				ini::ini_manager manager;
+				expect(manager.stats().sections == 0U);
+				expect(manager.stats().largest_section.empty());
+
+				std::istringstream stream{"[ab]\nx = 1\ny = 22\n[c]\nkey = value\n[e]\n"};
+				expect(manager.add_from_stream(stream).has_value());
+				auto stats = manager.stats();
+				expect(stats.sections == 3U);
+				expect(stats.keys == 3U);
+				expect(stats.payload_bytes == 4U + 2U + 3U + 8U);
+				expect(stats.largest_section == "ab");
+				expect(stats.largest_section_keys == 2U);
+
+				manager.set_value("c", "key", "v");
+				manager.set_value("c", "more", "1");
+				manager.set_value("c", "most", "2");
+				stats = manager.stats();
+				expect(stats.keys == 5U);
+				expect(stats.payload_bytes == 4U + 2U + 3U + 4U + 5U + 5U);
+				expect(stats.largest_section == "c");
+				expect(stats.largest_section_keys == 3U);
+
+				manager.remove_value(ini::section{"c"}, ini::key{"more"});
+				manager.remove_value(ini::section{"c"}, ini::key{"most"});
+				expect(manager.stats().largest_section == "ab");
+				manager.remove_section(ini::section{"ab"});
+				stats = manager.stats();
+				expect(stats.sections == 2U);
+				expect(stats.keys == 1U);
+				expect(stats.payload_bytes == 2U + 4U);
+				expect(stats.largest_section == "c");
+				expect(stats.largest_section_keys == 1U);
+
+				// Ties go to the alphabetically first section
+				manager.remove_section(ini::section{"c"});
+				manager.set_value("e", "key", "1");
+				manager.set_value("d", "key", "1");
+				expect(manager.stats().largest_section == "d");
+				manager.set_value("a", "key", "1");
+				stats = manager.stats();
+				expect(stats.largest_section == "a");
+				expect(stats.largest_section_keys == 1U);
+			};
+		};
+
+		describe("ini::ini_manager::fingerprint") = [] {
+			it("should not depend on how the data was built") = [] {
+				ini::ini_manager first;
+				first.set_value("b", "key", "value");
+				first.set_value("a", "x", 1);
+				first.set_section("empty");
+
+				std::istringstream stream{"[empty]\n[a]\nx = 1\n[b]\nkey = value\n"};
+				auto second = ini::ini_manager::from_stream(stream);
+				expect(second.has_value());
+				expect(first.fingerprint() == second->fingerprint());
+				expect(first.fingerprint128() == second->fingerprint128());
+				expect(first == *second);
+				expect(first.section_fingerprint(ini::section{"a"}) ==
+					   second->section_fingerprint(ini::section{"a"}));
+			};
+
+			it("should follow every kind of change") = [] {
+				ini::ini_manager manager;
+				const auto empty = manager.fingerprint128();
+				expect(empty == ini::ini_manager{}.fingerprint128());
+
+				manager.set_section("section");
+				const auto with_section = manager.fingerprint128();
+				expect(with_section != empty);
+
+				manager["section"]["key"] = "value";
+				const auto with_value = manager.fingerprint128();
+				expect(with_value != with_section);
+				const auto section_value =
+					manager.section_fingerprint128(ini::section{"section"});
+
+				manager.set_value("section", "key", "other");
+				expect(manager.fingerprint128() != with_value);
+				manager["section"]["key"] = "value";
+				expect(manager.fingerprint128() == with_value);
+				expect(manager.section_fingerprint128(ini::section{"section"}) ==
+					   section_value);
+
+				manager.set_value("other", "key", "value");
+				expect(manager.section_fingerprint128(ini::section{"section"}) ==
+					   section_value);
+				expect(manager.remove_section(ini::section{"other"}));
+				expect(manager.fingerprint128() == with_value);
+
+				expect(manager.remove_value(ini::section{"section"}, ini::key{"key"}));
+				expect(manager.fingerprint128() == with_section);
+				expect(manager.remove_section(ini::section{"section"}));
+				expect(manager.fingerprint128() == empty);
+				expect(!manager.section_fingerprint(ini::section{"section"}));
+			};
+
+			it("should tell apart values moved between keys and sections") = [] {
+				ini::ini_manager first;
+				first.set_value("section", "a", "1");
+				first.set_value("section", "b", "2");
+				ini::ini_manager second;
+				second.set_value("section", "a", "2");
+				second.set_value("section", "b", "1");
+				ini::ini_manager third;
+				third.set_value("section", "a", "1");
+				third.set_value("other", "b", "2");
+				expect(first != second);
+				expect(first != third);
+				expect(first.fingerprint() != second.fingerprint());
+			};
+
+			it("should count declared parents") = [] {
+				const auto make = [] {
+					ini::ini_manager manager;
+					manager.set_value("child", "key", "value");
+					manager.set_section("base");
+					return manager;
+				};
+				auto first = make();
+				const auto before = first.fingerprint128();
+				auto second = make();
+				expect(second.set_parent("child", "base").has_value());
+				expect(first != second);
+				expect(first.section_fingerprint(ini::section{"child"}) !=
+					   second.section_fingerprint(ini::section{"child"}));
+				expect(first.set_parent("child", "base").has_value());
+				expect(first == second);
+				expect(first.set_parent("child", "").has_value());
+				expect(first.fingerprint128() == before);
+			};
+		};
+
+		describe("ini::compression") = [] {
+			const auto directory = std::filesystem::temp_directory_path();
+			const auto gzip_path = (directory / "ini_manager_gzip_test.ini.gz").string();
+
+#if INI_MANAGER_HAS_ZLIB
+			const auto first_bytes = [](const std::string &path) {
+				std::string bytes(2, '\0');
+				std::ifstream(path, std::ios::binary).read(bytes.data(), 2);
+				return bytes;
+			};
+
+			it("should round-trip gzip files larger than one block") = [&] {
+				ini::ini_manager manager;
+				for (int index = 0; index < 20000; ++index)
+				{
+					manager.set_value(std::format("section_{}", index % 100),
+									  std::format("key_{}", index), index);
+				}
+				expect(manager.write_file(gzip_path).has_value());
+				expect(first_bytes(gzip_path) == "\x1f\x8b");
+
+				auto loaded = ini::ini_manager::from_file(gzip_path);
+				expect(loaded.has_value());
+				expect(loaded->get_value<int>(ini::section{"section_99"},
+											  ini::key{"key_19999"}) == 19999);
+				expect(loaded->get_keys(ini::section{"section_0"}).size() == 200U);
+
+				// write_file() keeps the compression of the loaded path
+				expect(loaded->write_file().has_value());
+				expect(first_bytes(gzip_path) == "\x1f\x8b");
+			};
+
+			it("should honor an explicit compression") = [&] {
+				ini::ini_manager manager;
+				manager.set_value("section", "key", "value");
+				expect(manager.write_file(gzip_path, ini::compression::none).has_value());
+				expect(first_bytes(gzip_path) == "[s");
+
+				const auto plain_path =
+					(directory / "ini_manager_gzip_test.ini").string();
+				expect(
+					manager.write_file(plain_path, ini::compression::gzip).has_value());
+				auto loaded = ini::ini_manager::from_file(
+					plain_path, {.compression = ini::compression::gzip});
+				expect(loaded.has_value() &&
+					   loaded->get_value(ini::section{"section"}, ini::key{"key"}) ==
+						   "value");
+				std::filesystem::remove(plain_path);
+			};
+
+			it("should report corrupt and truncated gzip files") = [&] {
+				ini::ini_manager manager;
+				manager.set_value("section", "key", "value");
+				expect(manager.write_file(gzip_path).has_value());
+				const auto size = std::filesystem::file_size(gzip_path);
+				std::filesystem::resize_file(gzip_path, size - 4);
+				auto truncated = ini::ini_manager::from_file(gzip_path);
+				expect(!truncated.has_value() &&
+					   truncated.error() == std::errc::bad_message);
+
+				std::ofstream(gzip_path, std::ios::binary) << "\x1f\x8bnot gzip";
+				auto corrupt = ini::ini_manager::from_file(gzip_path);
+				expect(!corrupt.has_value() && corrupt.error() == std::errc::bad_message);
+			};
+#else
+			it("should report gzip as unsupported") = [&] {
+				ini::ini_manager manager;
+				manager.set_value("s", "k", "v");
+				expect(manager.write_file(gzip_path, ini::compression::gzip).error() ==
+					   std::errc::not_supported);
+				// Detection falls back to plain text
+				expect(manager.write_file(gzip_path).has_value());
+				expect(ini::ini_manager::from_file(gzip_path)->get_value(
+						   ini::section{"s"}, ini::key{"k"}) == "v");
+				std::ofstream(gzip_path, std::ios::binary) << "\x1f\x8b";
+				expect(ini::ini_manager::from_file(gzip_path).error() ==
+					   std::errc::not_supported);
+			};
+#endif
+
+			std::filesystem::remove(gzip_path);
+		};
+
+		describe("ini::make_patch and ini::apply_patch") = [] {
+			const auto make_base = [] {
+				ini::ini_manager manager;
+				manager.set_value("server", "host", "localhost");
+				manager.set_value("server", "port", "8080");
+				manager.set_value("legacy", "enabled", "true");
+				manager.set_value("client", "retries", "3");
+				return manager;
+			};
+			auto target = make_base();
+			target.set_value("server", "port", "9090");
+			target.remove_value(ini::section{"server"}, ini::key{"host"});
+			target.remove_section(ini::section{"legacy"});
+			target.set_value("new", "multi line", "a\nb = c");
+			target.set_section("empty");
+			const auto patch = ini::make_patch(make_base(), target);
+
+			it("should list only the differences") = [&] {
+				expect(patch.find("client") == std::string::npos);
+				expect(patch.find("retries") == std::string::npos);
+				// Identical configurations only need the header line
+				expect(std::ranges::count(ini::make_patch(target, target), '\n') == 1);
+			};
+
+			it("should turn the base into the target") = [&] {
+				auto manager = make_base();
+				expect(ini::apply_patch(manager, patch).has_value());
+				expect(manager.get_sections() ==
+					   std::vector<std::string>{"client", "empty", "new", "server"});
+				expect(manager.get_keys(ini::section{"server"}) ==
+					   std::vector<std::string>{"port"});
+				expect(manager.get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "9090");
+				expect(manager.get_value(ini::section{"new"}, ini::key{"multi line"}) ==
+					   "a\nb = c");
+				expect(manager.get_value(ini::section{"client"}, ini::key{"retries"}) ==
+					   "3");
+
+				// Applying the same patch again is a no-op
+				expect(ini::apply_patch(manager, patch).has_value());
+				expect(std::ranges::count(ini::make_patch(manager, target), '\n') == 1);
+			};
+
+			it("should refuse a different base") = [&] {
+				auto manager = make_base();
+				manager.set_value("client", "retries", "5");
+				const auto result = ini::apply_patch(manager, patch);
+				expect(!result.has_value() &&
+					   result.error() == std::errc::operation_not_permitted);
+				expect(manager.get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "8080");
+
+				// A base differing only in the high half of its fingerprint
+				auto forged = patch;
+				forged[11] = forged[11] == '0' ? '1' : '0';
+				auto other = make_base();
+				expect(ini::apply_patch(other, forged).error() ==
+					   std::errc::operation_not_permitted);
+			};
+
+			it("should reject malformed patches without changing anything") = [&] {
+				auto manager = make_base();
+				const auto truncated = patch.substr(0, patch.size() - 3);
+				expect(ini::apply_patch(manager, truncated).error() ==
+					   std::errc::invalid_argument);
+				expect(ini::apply_patch(manager, "garbage").error() ==
+					   std::errc::invalid_argument);
+				auto future = patch;
+				future.replace(9, 1, "3");
+				expect(ini::apply_patch(manager, future).error() ==
+					   std::errc::not_supported);
+				expect(manager.get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "8080");
+			};
+
+			it("should carry parent declarations") = [&] {
+				auto parented = make_base();
+				expect(ini::apply_patch(parented, patch).has_value());
+				expect(parented.set_parent("server", "client").has_value());
+				expect(parented.set_parent("added", "server").has_value());
+				auto manager = make_base();
+				expect(ini::apply_patch(manager, ini::make_patch(manager, parented))
+						   .has_value());
+				expect(manager == parented);
+				expect(manager.get_parent(ini::section{"added"}) == "server");
+				expect(manager.get_value(ini::section{"server"}, ini::key{"retries"}) ==
+					   "3");
+
+				expect(ini::apply_patch(manager, ini::make_patch(parented, target))
+						   .has_value());
+				expect(manager == target);
+				expect(!manager.get_parent(ini::section{"server"}));
+			};
+
+			it("should refuse parent cycles without changing anything") = [&] {
+				auto manager = make_base();
+				// The header of an empty patch carries the right base fingerprint
+				const auto cyclic =
+					ini::make_patch(manager, manager) + "[ 1:a\n^ 1:b\n[ 1:b\n^ 1:a\n";
+				expect(ini::apply_patch(manager, cyclic).error() ==
+					   std::errc::too_many_symbolic_link_levels);
+				expect(!manager.get_parent(ini::section{"a"}));
+				expect(manager.set_parent("c", "a").has_value());
+
+				// Re-parenting through an intermediate cycle is fine
+				expect(manager.set_parent("b", "a").has_value());
+				auto swapped = make_base();
+				swapped.set_section("b");
+				expect(swapped.set_parent("a", "b").has_value());
+				expect(swapped.set_parent("c", "a").has_value());
+				expect(ini::apply_patch(manager, ini::make_patch(manager, swapped))
+						   .has_value());
+				expect(manager.get_parent(ini::section{"a"}) == "b");
+			};
+		};
+
+		describe("ini::binary_config") = [] {
+			const auto binary_path =
+				(std::filesystem::temp_directory_path() / "ini_manager_test.inib")
+					.string();
+
+			it("should round-trip values saved with save_binary") = [&] {
+				ini::ini_manager manager;
+				manager.set_value("server", "host", "localhost");
+				manager.set_value("server", "port", 8080);
+				manager.set_value("flags", "enabled", "true");
+				manager.set_value("flags", "alias", "localhost");
+				manager.set_section("empty");
+				expect(manager.save_binary(binary_path).has_value());
+
+				auto result = ini::binary_config::from_binary(binary_path);
+				expect(result.has_value());
+				const auto &config = result.value();
+				expect(config.get_value(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+				expect(config.get_value<int>(ini::section{"server"}, ini::key{"port"}) ==
+					   8080);
+				expect(config.get_value<bool>(ini::section{"flags"},
+											  ini::key{"enabled"}) == true);
+				expect(config.get_value_view(ini::section{"flags"},
+											 ini::key{"alias"}) == "localhost");
+				expect(!config.get_value(ini::section{"server"}, ini::key{"missing"}));
+				expect(!config.get_value(ini::section{"missing"}, ini::key{"host"}));
+				expect(config.get_value_or_default(ini::section{"server"},
+												   ini::key{"missing"},
+												   std::string{"fallback"}) ==
+					   "fallback");
+				expect(config.get_sections() ==
+					   std::vector<std::string>{"empty", "flags", "server"});
+				expect(config.get_keys(ini::section{"server"}) ==
+					   std::vector<std::string>{"host", "port"});
+				expect(config.get_keys(ini::section{"empty"}).empty());
+				expect(config.verify());
+				std::filesystem::remove(binary_path);
+			};
+
+			it("should load an empty configuration") = [&] {
+				const ini::ini_manager manager;
+				expect(manager.save_binary(binary_path).has_value());
+				auto result = ini::binary_config::from_binary(binary_path);
+				expect(result.has_value());
+				expect(result->get_sections().empty());
+				expect(!result->get_value(ini::section{"section"}, ini::key{"key"}));
+				std::filesystem::remove(binary_path);
+			};
+
+			it("should reject files that are not binary INI images") = [&] {
+				std::ofstream(binary_path) << "[section]\nkey = value\n";
+				auto result = ini::binary_config::from_binary(binary_path);
+				expect(!result.has_value());
+				expect(result.error() == std::errc::invalid_argument);
+				std::filesystem::remove(binary_path);
+			};
+
+			it("should detect corruption through the checksum") = [&] {
+				ini::ini_manager manager;
+				manager.set_value("section", "key", "value");
+				expect(manager.save_binary(binary_path).has_value());
+				{
+					std::fstream file(binary_path,
+									  std::ios::in | std::ios::out | std::ios::binary);
+					file.seekp(-1, std::ios::end);
+					file.put('#');
+				}
+				auto result = ini::binary_config::from_binary(binary_path);
+				expect(!result.has_value());
+				expect(result.error() == std::errc::bad_message);
+				expect(ini::binary_config::from_binary(binary_path, false).has_value());
+				std::filesystem::remove(binary_path);
+			};
+
+			it("should report missing files") = [] {
+				auto result = ini::binary_config::from_binary("nonexistent.inib");
+				expect(!result.has_value());
+			};
+
+			it("should refuse configurations declaring parents") = [&] {
+				ini::ini_manager manager;
+				expect(manager.set_parent("child", "base").has_value());
+				expect(manager.to_binary().error() == std::errc::not_supported);
+				expect(manager.save_binary(binary_path).error() ==
+					   std::errc::not_supported);
+				expect(manager.set_parent("child", "").has_value());
+				expect(manager.to_binary().has_value());
+			};
+		};
 	};
 }
 // NOLINTEND(*-magic-numbers)
@@ -0,0 +1,115 @@
+#include "ini_manager/layered_ini.hpp"
+
+#include <boost/ut.hpp>
+
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+
+auto parse(const std::string &text) -> ini::ini_manager
+{
+	std::istringstream stream{text};
+	return *ini::ini_manager::from_stream(stream);
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite layered_ini_tests = [] {
+		describe("ini::layered_ini") = [] {
+			it("should resolve lookups from the topmost layer") = [] {
+				ini::layered_ini config;
+				expect(config
+						   .add_layer("defaults",
+									  parse("[server]\nhost=localhost\nport=80\n"))
+						   .has_value());
+				expect(
+					config.add_layer("site", parse("[server]\nport=8080\n")).has_value());
+				expect(
+					config.add_layer("cli", parse("[log]\nlevel=debug\n")).has_value());
+
+				const ini::section server{"server"};
+				expect(config.get_value<int>(server, ini::key{"port"}) == 8080);
+				expect(config.get_value(server, ini::key{"host"}) == "localhost");
+				expect(config.get_value_view(ini::section{"log"}, ini::key{"level"}) ==
+					   "debug");
+				expect(!config.get_value(server, ini::key{"missing"}));
+				expect(config.get_value_or_default<int>(server, ini::key{"missing"}, 7) ==
+					   7);
+
+				expect(config.winning_layer(server, ini::key{"port"}) == "site");
+				expect(config.winning_layer(server, ini::key{"host"}) == "defaults");
+				expect(!config.winning_layer(server, ini::key{"missing"}));
+				const auto found = config.find(server, ini::key{"port"});
+				expect(found.has_value() && found->layer == "site" &&
+					   found->value == "8080");
+			};
+
+			it("should update one layer without touching the others") = [] {
+				ini::layered_ini config;
+				auto defaults = parse("[server]\nport=80\n");
+				config.add_layer("defaults", defaults);
+				config.add_layer("env");
+				const ini::section server{"server"};
+
+				config.layer("env")->set_value("server", "port", 9090);
+				expect(config.get_value<int>(server, ini::key{"port"}) == 9090);
+				expect(config.winning_layer(server, ini::key{"port"}) == "env");
+
+				expect(config.set_layer("env", {}).has_value());
+				expect(config.get_value<int>(server, ini::key{"port"}) == 80);
+				defaults.set_value("server", "port", 81);
+				expect(config.get_value<int>(server, ini::key{"port"}) == 81);
+
+				expect(config.remove_layer("defaults"));
+				expect(!config.remove_layer("defaults"));
+				expect(!config.get_value(server, ini::key{"port"}));
+				expect(config.layer("defaults") == nullptr);
+			};
+
+			it("should reject duplicate and unknown layer names") = [] {
+				ini::layered_ini config;
+				expect(config.add_layer("defaults").has_value());
+				expect(config.add_layer("defaults").error() == std::errc::file_exists);
+				expect(config.set_layer("cli", {}).error() ==
+					   std::errc::no_such_file_or_directory);
+				config.add_layer("cli");
+				expect(config.layer_count() == 2U);
+				expect(std::vector<std::string_view>(config.layer_names().begin(),
+													 config.layer_names().end()) ==
+					   std::vector<std::string_view>{"defaults", "cli"});
+			};
+
+			it("should list and flatten the union of all layers") = [] {
+				ini::layered_ini config;
+				config.add_layer("defaults", parse("[a]\nx=1\ny=2\n[empty]\n"));
+				config.add_layer("host", parse("[a]\ny=3\nz=4\n[b]\nw=5\n"));
+
+				expect(config.get_sections() ==
+					   std::vector<std::string>{"a", "b", "empty"});
+				expect(config.get_keys(ini::section{"a"}) ==
+					   std::vector<std::string>{"x", "y", "z"});
+
+				const auto flat = config.flatten();
+				expect(flat.get_sections() ==
+					   std::vector<std::string>{"a", "b", "empty"});
+				expect(flat.get_value(ini::section{"a"}, ini::key{"y"}) == "3");
+				expect(flat.get_value(ini::section{"a"}, ini::key{"x"}) == "1");
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
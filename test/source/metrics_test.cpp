@@ -0,0 +1,121 @@
+#include "ini_manager/ini_manager.hpp"
+#include "ini_manager/metrics.hpp"
+
+#include <boost/ut.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+// The counters are global, so the tests compare differences between snapshots
+auto difference(const ini::metrics_snapshot &after, const ini::metrics_snapshot &before)
+	-> ini::metrics_snapshot
+{
+	ini::metrics_snapshot result;
+	for (std::size_t index = 0; index < result.values.size(); ++index)
+	{
+		result.values[index] = after.values[index] - before.values[index];
+	}
+	return result;
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite metrics_tests = [] {
+		// Every expected count is zero in builds without metrics
+		const std::uint64_t one = ini::metrics_enabled() ? 1 : 0;
+
+		describe("ini::metrics") = [one] {
+			it("should count lookups per API") = [one] {
+				std::istringstream stream{"[server]\nport = 80\n"};
+				const auto manager = *ini::ini_manager::from_stream(stream);
+				const ini::section server{"server"};
+				const ini::key port{"port"};
+				const ini::key absent{"absent"};
+
+				const auto before = ini::metrics();
+				expect(manager.get_value(server, port) == "80");
+				expect(!manager.get_value(server, absent));
+				expect(!manager.get_value(ini::section{"none"}, port));
+				expect(manager.get_value<int>(server, port) == 80);
+				expect(manager.get_value_view(server, port) == "80");
+				expect(!manager["server"]["absent"]);
+				const auto counted = difference(ini::metrics(), before);
+
+				const auto get_value = counted.lookups(ini::lookup_api::get_value);
+				expect(get_value.hits == one && get_value.misses == 2 * one);
+				expect(get_value.lookups() == 3 * one);
+				expect(counted.lookups(ini::lookup_api::get_value_as).hits == one);
+				expect(counted.lookups(ini::lookup_api::get_value_view).hits == one);
+				expect(counted.lookups(ini::lookup_api::subscript).misses == one);
+				expect(counted.lookups(ini::lookup_api::subscript).hits == 0U);
+			};
+
+			it("should count parsed and written text, loads and merges") = [one] {
+				const std::string text{"[a]\nx = 1\n[b]\ny = 2\n"};
+				const auto before = ini::metrics();
+				std::istringstream stream{text};
+				auto manager = *ini::ini_manager::from_stream(stream);
+				std::istringstream more{"[c]\nz = 3\n"};
+				expect(manager.add_from_stream(more).has_value());
+				std::ostringstream written;
+				written << manager;
+				const auto counted = difference(ini::metrics(), before);
+
+				expect(counted.parses() == 2 * one);
+				expect(counted.parsed_lines() == 6 * one);
+				expect(counted.parsed_bytes() == (text.size() + 10) * one);
+				expect(counted.writes() == one);
+				expect(counted.written_bytes() == written.str().size() * one);
+				expect(counted.loads() == one);
+				expect(counted.merges() == one);
+			};
+
+			it("should add up the counters of exited threads") = [one] {
+				ini::ini_manager manager;
+				const auto before = ini::metrics();
+				std::thread worker{[&manager] {
+					for (int index = 0; index < 10; ++index)
+					{
+						(void)manager.get_value_view(ini::section{"a"}, ini::key{"b"});
+					}
+				}};
+				worker.join();
+				const auto counted = difference(ini::metrics(), before);
+				expect(counted.lookups(ini::lookup_api::get_value_view).misses ==
+					   10 * one);
+			};
+		};
+
+		describe("ini::write_prometheus") = [] {
+			it("should write every counter with its type") = [] {
+				ini::metrics_snapshot snapshot;
+				snapshot.values[static_cast<std::size_t>(
+					ini::detail::counter::get_value_view_misses)] = 7;
+				snapshot.values[static_cast<std::size_t>(
+					ini::detail::counter::loads)] = 2;
+				std::ostringstream output;
+				ini::write_prometheus(output, snapshot);
+				const auto text = output.str();
+				expect(text.contains("# TYPE ini_manager_lookups_total counter\n"));
+				expect(text.contains("ini_manager_lookups_total"
+									 "{api=\"get_value_view\",result=\"miss\"} 7\n"));
+				expect(text.contains("ini_manager_loads_total 2\n"));
+				expect(text.contains("ini_manager_merge_seconds_total 0\n"));
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
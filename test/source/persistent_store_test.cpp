@@ -0,0 +1,169 @@
+#include "ini_manager/persistent_store.hpp"
+
+#include <boost/ut.hpp>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite persistent_store_tests = [] {
+		describe("ini::persistent_store") = [] {
+			const auto directory = std::filesystem::temp_directory_path();
+			const auto path = (directory / "ini_manager_store_test.store").string();
+
+#if INI_MANAGER_HAS_MMAP
+			it("should persist updates across reopening") = [&path] {
+				std::filesystem::remove(path);
+				{
+					auto store = ini::persistent_store::open(path);
+					expect(store.has_value());
+					expect(store->set_value("server", "host", "localhost").has_value());
+					expect(store->set_value("server", "port", 8080).has_value());
+					expect(store->set_section("empty").has_value());
+				}
+				auto store = ini::persistent_store::open(path);
+				expect(store.has_value());
+				expect(store->get_value<int>(ini::section{"server"}, ini::key{"port"}) ==
+					   8080);
+				expect(store->get_value_view(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+				const auto unset = store->get_value_or_default(
+					ini::section{"server"}, ini::key{"none"}, std::string{"unset"});
+				expect(unset == "unset");
+				expect(store->get_sections() ==
+					   std::vector<std::string>{"empty", "server"});
+				expect(store->get_keys(ini::section{"server"}) ==
+					   std::vector<std::string>{"host", "port"});
+				expect(store->has_section(ini::section{"empty"}));
+				expect(store->size() == 2U);
+			};
+
+			it("should share updates with other mappings at once") = [&path] {
+				std::filesystem::remove(path);
+				auto writer = ini::persistent_store::open(path);
+				auto reader = ini::persistent_store::open(path);
+				expect(writer.has_value() && reader.has_value());
+
+				expect(writer->set_value("flags", "beta", true).has_value());
+				expect(reader->get_value<bool>(ini::section{"flags"}, ini::key{"beta"}) ==
+					   true);
+				expect(writer->set_value("flags", "alpha", true).has_value());
+				expect(reader->size() == 2U);
+				expect(writer->set_value("flags", "beta", false).has_value());
+				expect(reader->get_value<bool>(ini::section{"flags"}, ini::key{"beta"}) ==
+					   false);
+
+				expect(writer->remove_value(ini::section{"flags"}, ini::key{"beta"}) ==
+					   true);
+				expect(!reader->get_value(ini::section{"flags"}, ini::key{"beta"}));
+				expect(writer->remove_value(ini::section{"flags"}, ini::key{"beta"}) ==
+					   false);
+				expect(reader->has_section(ini::section{"flags"}));
+				expect(writer->remove_section(ini::section{"flags"}) == true);
+				expect(!reader->has_section(ini::section{"flags"}));
+				expect(reader->size() == 0U);
+			};
+
+			it("should remove keys past colliding and removed slots") = [&path] {
+				std::filesystem::remove(path);
+				auto store = ini::persistent_store::open(
+					path, {.initial_slots = 64, .durable = false});
+				expect(store.has_value());
+				for (int index = 0; index < 40; ++index)
+				{
+					expect(store->set_value("keys", std::format("key{}", index), index)
+							   .has_value());
+				}
+				for (int index = 0; index < 40; index += 2)
+				{
+					expect(store->remove_value(ini::section{"keys"},
+											   ini::key{std::format("key{}", index)}) ==
+						   true);
+				}
+				expect(store->remove_value(ini::section{"keys"}, ini::key{"key0"}) ==
+					   false);
+				expect(store->size() == 20U);
+				for (int index = 1; index < 40; index += 2)
+				{
+					expect(store->get_value<int>(ini::section{"keys"},
+												 ini::key{std::format("key{}", index)}) ==
+						   index);
+				}
+			};
+
+			it("should follow compaction from other mappings") = [&path, &directory] {
+				std::filesystem::remove(path);
+				const ini::store_options options{.initial_slots = 16,
+												 .initial_heap = 4096};
+				auto writer = ini::persistent_store::open(path, options);
+				auto reader = ini::persistent_store::open(path, options);
+				expect(writer.has_value() && reader.has_value());
+
+				for (int index = 0; index < 1000; ++index)
+				{
+					const auto key = std::format("key{}", index);
+					expect(writer->set_value("counters", key, index).has_value());
+				}
+				for (int index = 0; index < 1000; index += 2)
+				{
+					expect(writer->set_value("counters", "key0", index).has_value());
+				}
+				expect(reader->size() == 1000U);
+				expect(reader->get_value<int>(ini::section{"counters"},
+											  ini::key{"key999"}) == 999);
+				expect(reader->get_value<int>(ini::section{"counters"},
+											  ini::key{"key0"}) == 998);
+				// Compaction leaves no temporary file behind
+				for (const auto &entry : std::filesystem::directory_iterator{directory})
+				{
+					expect(!entry.path().string().ends_with(".compact"));
+				}
+			};
+
+			it("should export the store as INI text") = [&path, &directory] {
+				std::filesystem::remove(path);
+				auto store = ini::persistent_store::open(path, {.durable = false});
+				expect(store.has_value());
+				store->set_value("server", "host", "localhost");
+				store->set_section("empty");
+				expect(store->flush().has_value());
+
+				const auto export_path =
+					(directory / "ini_manager_store_test.ini").string();
+				expect(store->write_file(export_path).has_value());
+				const auto manager = ini::ini_manager::from_file(export_path);
+				expect(manager.has_value());
+				expect(manager->get_value(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+				expect(manager->get_sections() ==
+					   std::vector<std::string>{"empty", "server"});
+				std::filesystem::remove(export_path);
+			};
+
+			it("should reject files that are not stores") = [&path] {
+				std::ofstream{path} << "[server]\nhost=localhost\n";
+				expect(ini::persistent_store::open(path).error() ==
+					   std::errc::invalid_argument);
+				std::filesystem::remove(path);
+			};
+#else
+			it("should report missing mmap support") = [&path] {
+				expect(ini::persistent_store::open(path).error() ==
+					   std::errc::not_supported);
+			};
+#endif
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
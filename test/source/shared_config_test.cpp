@@ -0,0 +1,95 @@
+#include "ini_manager/shared_config.hpp"
+
+#include <boost/ut.hpp>
+
+#include <format>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if INI_MANAGER_HAS_MMAP
+#include <unistd.h>
+#endif
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite shared_config_tests = [] {
+		describe("ini::shared_config") = [] {
+			it("should reject names containing a slash") = [] {
+				expect(ini::publish_shared("a/b", ini::ini_manager{}).error() ==
+					   std::errc::invalid_argument);
+				expect(ini::shared_config::attach("").error() ==
+					   std::errc::invalid_argument);
+			};
+
+#if INI_MANAGER_HAS_MMAP
+			const auto name = std::format("ini_manager_test_{}", ::getpid());
+
+			it("should report a missing publication") = [&name] {
+				expect(!ini::shared_config::attach(name).has_value());
+			};
+
+			it("should keep old readers on their generation") = [&name] {
+				ini::ini_manager manager;
+				manager.set_value("server", "host", "localhost");
+				manager.set_value("server", "port", "8080");
+				const auto first = ini::publish_shared(name, manager);
+				expect(first.has_value());
+
+				auto reader = ini::shared_config::attach(name, true);
+				expect(reader.has_value());
+				expect(reader->generation() == *first);
+				expect(reader->is_current());
+				expect(reader->get_value<int>(ini::section{"server"},
+											  ini::key{"port"}) == 8080);
+
+				manager.set_value("server", "port", "9090");
+				manager.set_value("client", "retries", "3");
+				const auto second = ini::publish_shared(name, manager);
+				expect(second.has_value() && *second == *first + 1);
+
+				expect(!reader->is_current());
+				expect(reader->get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "8080");
+				expect(reader->get_sections() == std::vector<std::string>{"server"});
+
+				auto updated = ini::shared_config::attach(name);
+				expect(updated.has_value() && updated->is_current());
+				expect(updated->get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "9090");
+				expect(updated->get_value(ini::section{"client"},
+										  ini::key{"retries"}) == "3");
+
+				expect(ini::unlink_shared(name).has_value());
+				expect(!ini::shared_config::attach(name).has_value());
+				expect(reader->get_value(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+			};
+
+			it("should not keep readers current across an unlink") = [&name] {
+				ini::ini_manager manager;
+				manager.set_value("server", "port", "8080");
+				expect(ini::publish_shared(name, manager).has_value());
+				auto reader = ini::shared_config::attach(name);
+				expect(reader.has_value() && reader->is_current());
+
+				expect(ini::unlink_shared(name).has_value());
+				expect(!reader->is_current());
+				// A new publication starts over at the first generation
+				const auto republished = ini::publish_shared(name, manager);
+				expect(republished.has_value() && *republished == reader->generation());
+				expect(!reader->is_current());
+				expect(ini::shared_config::attach(name)->is_current());
+				expect(ini::unlink_shared(name).has_value());
+			};
+#endif
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
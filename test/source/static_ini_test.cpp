@@ -0,0 +1,90 @@
+#include "ini_manager/static_ini.hpp"
+
+#include <boost/ut.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr auto defaults = ini::static_ini<R"(
+; Embedded defaults
+[server]
+host = localhost
+port = 8080
+port = 9090
+
+[flags]
+verbose = true
+
+[server]
+timeout = 1.5
+
+[empty]
+)">;
+
+static_assert(defaults.section_count() == 3);
+static_assert(defaults.size() == 4);
+static_assert(defaults.get_value_view(ini::section{"server"}, ini::key{"host"}) ==
+			  "localhost");
+static_assert(defaults.get_value_view(ini::section{"server"}, ini::key{"port"}) ==
+			  "9090");
+static_assert(!defaults.get_value_view(ini::section{"server"}, ini::key{"missing"}));
+static_assert(!defaults.get_value_view(ini::section{"flags"}, ini::key{"host"}));
+static_assert(defaults.has_section(ini::section{"empty"}));
+static_assert(!defaults.has_section(ini::section{"missing"}));
+
+constexpr auto nothing = ini::static_ini<"">;
+static_assert(nothing.section_count() == 0 && nothing.size() == 0);
+static_assert(!nothing.get_value_view(ini::section{"section"}, ini::key{"key"}));
+
+constexpr ini::static_config defaults_view = defaults.view();
+static_assert(defaults_view.get_value_view(ini::section{"flags"},
+										   ini::key{"verbose"}) == "true");
+
+} // namespace
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+
+	const suite static_ini_tests = [] {
+		describe("ini::static_ini") = [] {
+			it("should convert values at runtime") = [] {
+				expect(defaults.get_value<int>(ini::section{"server"},
+											   ini::key{"port"}) == 9090);
+				expect(defaults.get_value<bool>(ini::section{"flags"},
+												ini::key{"verbose"}) == true);
+				expect(defaults.get_value<double>(ini::section{"server"},
+												  ini::key{"timeout"}) == 1.5);
+				expect(defaults.get_value(ini::section{"server"}, ini::key{"host"}) ==
+					   "localhost");
+				expect(defaults.get_value_or_default<int>(ini::section{"server"},
+														  ini::key{"missing"}, 7) == 7);
+			};
+
+			it("should list sections and keys in alphabetical order") = [] {
+				expect(defaults.get_sections() ==
+					   std::vector<std::string>{"empty", "flags", "server"});
+				expect(defaults.get_keys(ini::section{"server"}) ==
+					   std::vector<std::string>{"host", "port", "timeout"});
+				expect(defaults.get_keys(ini::section{"empty"}).empty());
+				expect(defaults.get_keys(ini::section{"missing"}).empty());
+			};
+
+			it("should copy into a mutable ini_manager") = [] {
+				auto manager = defaults.to_manager();
+				expect(manager.get_value(ini::section{"server"}, ini::key{"port"}) ==
+					   "9090");
+				expect(manager.get_sections() ==
+					   std::vector<std::string>{"empty", "flags", "server"});
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,172 @@
+#include "ini_manager/ini_manager.hpp"
+#include "ini_manager/tracing.hpp"
+
+#include <boost/ut.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Records the traced phases in the order they start and end.
+ */
+class recording_hook : public ini::trace_hook
+{
+  public:
+	struct record
+	{
+		ini::trace_event event;
+		std::string source;
+		std::uint64_t bytes;
+		bool succeeded;
+	};
+
+	void begin(ini::trace_event event,
+			   [[maybe_unused]] std::string_view source) noexcept override
+	{
+		started.push_back(event);
+	}
+
+	void end(const ini::trace_span &span) noexcept override
+	{
+		ended.push_back({span.event, std::string{span.source}, span.bytes,
+						 span.succeeded});
+	}
+
+	std::vector<ini::trace_event> started;
+	std::vector<record> ended;
+};
+
+/**
+ * @brief Installs a hook for the lifetime of a test.
+ */
+class installed
+{
+  public:
+	explicit installed(ini::trace_hook &hook) : m_previous(ini::set_trace_hook(&hook))
+	{
+	}
+
+	installed(const installed &) = delete;
+	auto operator=(const installed &) -> installed & = delete;
+
+	~installed()
+	{
+		ini::set_trace_hook(m_previous);
+	}
+
+  private:
+	ini::trace_hook *m_previous;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-magic-numbers)
+auto main() -> int
+{
+	using boost::ut::expect;
+	using boost::ut::suite;
+	using boost::ut::spec::describe;
+	using boost::ut::spec::it;
+	using ini::trace_event;
+
+	const suite tracing_tests = [] {
+		describe("ini::set_trace_hook") = [] {
+			it("should trace a load around its parse") = [] {
+				recording_hook hook;
+				const std::string text{"[a]\nx = 1\n"};
+				{
+					const installed guard{hook};
+					std::istringstream stream{text};
+					expect(ini::ini_manager::from_stream(stream).has_value());
+				}
+				expect(hook.started ==
+					   std::vector<trace_event>{trace_event::load, trace_event::parse});
+				expect(hook.ended.size() == 2U);
+				expect(hook.ended[0].event == trace_event::parse);
+				expect(hook.ended[1].event == trace_event::load);
+				expect(hook.ended[0].bytes == text.size());
+				expect(hook.ended[1].bytes == text.size());
+				expect(hook.ended[1].succeeded && hook.ended[1].source.empty());
+			};
+
+			it("should trace writes to files and merges from them") = [] {
+				const auto path =
+					(std::filesystem::temp_directory_path() / "ini_manager_tracing.ini")
+						.string();
+				ini::ini_manager manager;
+				manager.set_value("a", "x", "1");
+				recording_hook hook;
+				{
+					const installed guard{hook};
+					expect(manager.write_file(path).has_value());
+					expect(manager.add_from_file(path).has_value());
+				}
+				std::filesystem::remove(path);
+
+				expect(hook.ended.size() == 4U);
+				expect(hook.ended[0].event == trace_event::write);
+				expect(hook.ended[1].event == trace_event::write_file);
+				expect(hook.ended[1].source == path);
+				expect(hook.ended[1].bytes == hook.ended[0].bytes);
+				expect(hook.ended[0].bytes > 0U);
+				expect(hook.ended[2].event == trace_event::parse);
+				expect(hook.ended[3].event == trace_event::merge);
+				expect(hook.ended[3].bytes == hook.ended[1].bytes);
+				expect(hook.ended[3].succeeded);
+			};
+
+			it("should report failed phases") = [] {
+				recording_hook hook;
+				{
+					const installed guard{hook};
+					expect(!ini::ini_manager::from_file("/nonexistent/missing.ini"));
+				}
+				expect(hook.ended.size() == 1U);
+				expect(hook.ended[0].event == trace_event::load);
+				expect(!hook.ended[0].succeeded);
+				expect(hook.ended[0].source == "/nonexistent/missing.ini");
+			};
+
+			it("should stop tracing once the hook is removed") = [] {
+				recording_hook hook;
+				{
+					const installed guard{hook};
+					expect(ini::get_trace_hook() == &hook);
+				}
+				expect(ini::get_trace_hook() == nullptr);
+				// No tracer is attached to the probes of USDT builds either
+				expect(!ini::detail::tracing());
+				std::istringstream stream{"[a]\nx = 1\n"};
+				expect(ini::ini_manager::from_stream(stream).has_value());
+				expect(hook.started.empty() && hook.ended.empty());
+			};
+
+#if INI_MANAGER_HAS_USDT
+			it("should observe phases while a tracer raises a semaphore") = [] {
+				expect(!ini::detail::probed(trace_event::load));
+				++ini_manager_load_done_semaphore;
+				expect(ini::detail::probed(trace_event::load));
+				expect(!ini::detail::probed(trace_event::parse));
+				expect(ini::detail::tracing());
+				--ini_manager_load_done_semaphore;
+				expect(!ini::detail::tracing());
+			};
+#endif
+		};
+
+		describe("ini::to_string") = [] {
+			it("should name the phases as the probes do") = [] {
+				expect(ini::to_string(trace_event::write_file) == "write_file");
+				expect(ini::to_string(trace_event::merge) == "merge");
+			};
+		};
+	};
+}
+// NOLINTEND(*-magic-numbers)
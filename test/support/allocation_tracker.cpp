@@ -0,0 +1,188 @@
+#include "allocation_tracker.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Replaces every form of the global allocation functions. Plain deallocation
+// forwards to std::free; aligned deallocation too, except on Windows, which has no
+// std::aligned_alloc and must release _aligned_malloc memory with _aligned_free.
+
+namespace
+{
+
+// Constant-initialized, so counting works before main and during static destruction
+thread_local ini_test::allocation_counts counts;
+
+auto allocate(std::size_t size) noexcept -> void *
+{
+	++counts.allocations;
+	counts.bytes += size;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+auto allocate(std::size_t size, std::align_val_t alignment) noexcept -> void *
+{
+	++counts.allocations;
+	counts.bytes += size;
+	const auto align = static_cast<std::size_t>(alignment);
+	// std::aligned_alloc requires a nonzero multiple of the alignment
+	const auto rounded = size == 0 ? align : (size + align - 1) / align * align;
+#if defined(_WIN32)
+	return _aligned_malloc(rounded, align);
+#else
+	return std::aligned_alloc(align, rounded);
+#endif
+}
+
+void deallocate_aligned(void *pointer) noexcept
+{
+#if defined(_WIN32)
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+auto allocate_or_throw(std::size_t size) -> void *
+{
+	if (auto *pointer = allocate(size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc{};
+}
+
+auto allocate_or_throw(std::size_t size, std::align_val_t alignment) -> void *
+{
+	if (auto *pointer = allocate(size, alignment))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc{};
+}
+
+} // namespace
+
+namespace ini_test
+{
+
+auto current_allocations() noexcept -> allocation_counts
+{
+	return counts;
+}
+
+} // namespace ini_test
+
+// NOLINTBEGIN(*-no-malloc, *-owning-memory)
+auto operator new(std::size_t size) -> void *
+{
+	return allocate_or_throw(size);
+}
+
+auto operator new[](std::size_t size) -> void *
+{
+	return allocate_or_throw(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void *
+{
+	return allocate_or_throw(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void *
+{
+	return allocate_or_throw(size, alignment);
+}
+
+auto operator new(std::size_t size, const std::nothrow_t & /*unused*/) noexcept -> void *
+{
+	return allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t & /*unused*/) noexcept
+	-> void *
+{
+	return allocate(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment,
+				  const std::nothrow_t & /*unused*/) noexcept -> void *
+{
+	return allocate(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment,
+					const std::nothrow_t & /*unused*/) noexcept -> void *
+{
+	return allocate(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t /*size*/) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t /*size*/) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t /*alignment*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t /*alignment*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+
+void operator delete(void *pointer, std::size_t /*size*/,
+					 std::align_val_t /*alignment*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t /*size*/,
+					   std::align_val_t /*alignment*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t & /*unused*/) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t & /*unused*/) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t /*alignment*/,
+					 const std::nothrow_t & /*unused*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t /*alignment*/,
+					   const std::nothrow_t & /*unused*/) noexcept
+{
+	deallocate_aligned(pointer);
+}
+// NOLINTEND(*-no-malloc, *-owning-memory)
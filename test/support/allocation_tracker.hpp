@@ -0,0 +1,52 @@
+#ifndef INI_MANAGER_TEST_ALLOCATION_TRACKER_HPP
+#define INI_MANAGER_TEST_ALLOCATION_TRACKER_HPP
+
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file allocation_tracker.hpp
+ * @brief Counts heap allocations made through the global `operator new`.
+ *
+ * Linking `allocation_tracker.cpp` into a test or benchmark replaces the global
+ * allocation functions with counting ones. Counts are kept per thread, so a
+ * measurement only sees the allocations of the thread taking it.
+ */
+
+namespace ini_test
+{
+
+/**
+ * @brief A number of allocations and the bytes they requested.
+ */
+struct allocation_counts
+{
+	std::uint64_t allocations = 0;
+	std::uint64_t bytes = 0;
+
+	auto operator==(const allocation_counts &) const -> bool = default;
+};
+
+/**
+ * @brief Gets the allocations the calling thread has made so far.
+ * @return The running totals.
+ */
+auto current_allocations() noexcept -> allocation_counts;
+
+/**
+ * @brief Counts the allocations a call makes on the calling thread.
+ * @param function The function to call.
+ * @return The allocations made while it ran.
+ */
+template <typename Function>
+auto count_allocations(Function &&function) -> allocation_counts
+{
+	const auto before = current_allocations();
+	std::forward<Function>(function)();
+	const auto after = current_allocations();
+	return {after.allocations - before.allocations, after.bytes - before.bytes};
+}
+
+} // namespace ini_test
+
+#endif // INI_MANAGER_TEST_ALLOCATION_TRACKER_HPP
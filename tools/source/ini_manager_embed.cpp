@@ -0,0 +1,190 @@
+#include "ini_manager/ini_manager.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Converts an INI file into a C++ header and source defining an `ini::static_config`
+// over pre-hashed, read-only tables, so the data is linked into the binary and never
+// parsed at startup. Invoked by the `ini_manager_embed()` CMake function.
+// Usage: ini_manager_embed <input.ini> <output_dir> <name> [namespace]
+
+namespace
+{
+
+struct embedded_entry
+{
+	std::string section;
+	std::string key;
+	std::string value;
+	std::uint64_t hash;
+};
+
+auto is_identifier(std::string_view name) -> bool
+{
+	const auto is_word = [](char character) {
+		return character == '_' || (character >= 'a' && character <= 'z') ||
+			   (character >= 'A' && character <= 'Z') ||
+			   (character >= '0' && character <= '9');
+	};
+	return !name.empty() && (name.front() < '0' || name.front() > '9') &&
+		   std::ranges::all_of(name, is_word);
+}
+
+auto is_namespace(std::string_view name) -> bool
+{
+	for (const auto part : std::views::split(name, std::string_view{"::"}))
+	{
+		if (!is_identifier(std::string_view{part.begin(), part.end()}))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Octal escapes never swallow the following character, unlike hexadecimal ones
+auto literal(std::string_view text) -> std::string
+{
+	std::string result{"std::string_view{\""};
+	for (const char character : text)
+	{
+		const auto byte = static_cast<unsigned char>(character);
+		if (character == '"' || character == '\\')
+		{
+			result += '\\';
+			result += character;
+		}
+		else if (byte < 0x20 || byte >= 0x7F || character == '?')
+		{
+			result += std::format("\\{:03o}", byte);
+		}
+		else
+		{
+			result += character;
+		}
+	}
+	result += std::format("\", {}}}", text.size());
+	return result;
+}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	if (argc < 4 || argc > 5)
+	{
+		std::cerr << "Usage: ini_manager_embed <input.ini> <output_dir> <name> "
+					 "[namespace]\n";
+		return 2;
+	}
+	const std::string input_path{argv[1]};
+	const std::filesystem::path output_dir{argv[2]};
+	const std::string name{argv[3]};
+	const std::string name_space{argc == 5 ? argv[4] : "ini_embedded"};
+	if (!is_identifier(name) || !is_namespace(name_space))
+	{
+		std::cerr << "ini_manager_embed: name and namespace must be C++ identifiers\n";
+		return 2;
+	}
+
+	auto manager = ini::ini_manager::from_file(input_path);
+	if (!manager.has_value())
+	{
+		std::cerr << std::format("ini_manager_embed: cannot read '{}': {}\n", input_path,
+								 manager.error().message());
+		return 1;
+	}
+
+	// Same order as static_ini: sections by name, entries by section and key
+	const auto sections = manager->get_sections();
+	std::vector<embedded_entry> entries;
+	for (const auto &section : sections)
+	{
+		for (const auto &key : manager->get_keys(ini::section{section}))
+		{
+			auto value = manager->get_value(ini::section{section}, ini::key{key});
+			entries.push_back({section, key, std::move(*value),
+							   ini::detail::hash_entry(section, key)});
+		}
+	}
+	std::vector<std::size_t> index(entries.size());
+	for (std::size_t position = 0; position < index.size(); ++position)
+	{
+		index[position] = position;
+	}
+	std::ranges::sort(index, {}, [&entries](std::size_t position) {
+		return entries[position].hash;
+	});
+
+	std::error_code error;
+	std::filesystem::create_directories(output_dir, error);
+	const auto header_path = output_dir / (name + ".hpp");
+	const auto source_path = output_dir / (name + ".cpp");
+
+	std::ofstream header(header_path);
+	header << std::format("// Generated by ini_manager_embed from {}. Do not edit.\n\n",
+						  input_path);
+	header << std::format("#ifndef INI_MANAGER_EMBED_{}_HPP\n", name);
+	header << std::format("#define INI_MANAGER_EMBED_{}_HPP\n\n", name);
+	header << "#include \"ini_manager/static_ini.hpp\"\n\n";
+	header << std::format("namespace {}\n{{\n\n", name_space);
+	header << std::format("extern const ini::static_config {};\n\n", name);
+	header << std::format("}} // namespace {}\n\n", name_space);
+	header << std::format("#endif // INI_MANAGER_EMBED_{}_HPP\n", name);
+
+	std::ofstream source(source_path);
+	source << std::format("// Generated by ini_manager_embed from {}. Do not edit.\n\n",
+						  input_path);
+	source << std::format("#include \"{}.hpp\"\n\n", name);
+	source << "#include <array>\n#include <string_view>\n\nnamespace\n{\n\n";
+	source << std::format(
+		"constexpr std::array<std::string_view, {}> embedded_sections{{{{\n",
+		sections.size());
+	for (const auto &section : sections)
+	{
+		source << std::format("\t{},\n", literal(section));
+	}
+	source << "}};\n\n";
+	source << std::format(
+		"constexpr std::array<ini::static_entry, {}> embedded_entries{{{{\n",
+		entries.size());
+	for (const auto &entry : entries)
+	{
+		source << std::format("\t{{{}, {}, {}}},\n", literal(entry.section),
+							  literal(entry.key), literal(entry.value));
+	}
+	source << "}};\n\n";
+	source << std::format(
+		"constexpr std::array<ini::static_index, {}> embedded_index{{{{\n",
+		entries.size());
+	for (const auto position : index)
+	{
+		source << std::format("\t{{0x{:016x}ULL, {}}},\n", entries[position].hash,
+							  position);
+	}
+	source << "}};\n\n} // namespace\n\n";
+	source << std::format("namespace {}\n{{\n\n", name_space);
+	source << std::format("constinit const ini::static_config {}{{\n\tembedded_sections, "
+						  "embedded_entries, embedded_index}};\n\n",
+						  name);
+	source << std::format("}} // namespace {}\n", name_space);
+
+	header.close();
+	source.close();
+	if (header.fail() || source.fail())
+	{
+		std::cerr << std::format("ini_manager_embed: cannot write to '{}'\n",
+								 output_dir.string());
+		return 1;
+	}
+	return 0;
+}